@@ -3,6 +3,9 @@
 # By default log.html and log.logcat files are made in currend directory $PWD.
 # If you do not like this change this line.
 LOG_DIR="$PWD"
+# Long sessions start new files every 64 MB and keep 10 old ones,
+# so logs do not fill disk. Leave empty for one unbounded file.
+ROTATION="--rotate-size=64 --keep=10"
 
 PROGRAM_NAME=$0
 
@@ -37,7 +40,8 @@ done
 set -o pipefail
 
 adb logcat -v time *:V 2>&1 | coloring_tee \
-	--color-schemes=logcat --html="$LOG_DIR/log.html" "$LOG_DIR/log.logcat"
+	--color-schemes=logcat $ROTATION \
+	--html="$LOG_DIR/log.html" "$LOG_DIR/log.logcat"
 	
 exit $?
 
@@ -1,5 +1,7 @@
 
 -- Posible colors.
+-- Besides these names, color could be palette index as '0' to '255'
+-- or RGB color as '#rrggbb'.
 black = 'black'
 red = 'red'
 green = 'green'
@@ -11,31 +13,54 @@ white = 'white'
 
 
 -- Configuration table.
+--
+-- Every rule have color and searchString or pattern,
+-- and could have background with same posible colors.
+-- searchString is plain string searched in line.
+-- pattern is regular expression, subset of POSIX extended ones:
+-- ".", [...] with ranges and [:class:], \\d \\w \\s \\D \\W \\S,
+-- groups, "|", "*", "+", "?", {n,m}, "^" and "$".
+-- Rule with searchString could also have position where string must be:
+-- anchor = 'start' or 'end', column = N for byte column N or
+-- field = K for start of K-th field separated with spaces, counting from 1.
+-- Comparing on known position is faster than searching whole line.
+-- Rule with error = true counts its lines as errors
+-- in index of HTML file split to pages.
+-- When line match many rules, one with highest priority wins.
+-- Priority is number, 0 if rule does not have it. Lua does not keep order
+-- of table, so rules with same priority go in order of their scheme names
+-- and then rule names.
 coloring_tee_config = {
+	-- Maximal memory for regular expression automaton, in bytes.
+	dfa_cache_size = 2097152,
+
 	color_schemes = {
 
 		gcc = {
 			-- For all.
 			noSuchFileOrDirectory = {
 				searchString = ': No such file or directory',
-				color = red
+				color = red,
+				error = true
 			},
 			-- gcc.
 			error = { 
-				searchString = 'error:',
-				color = red
+				pattern = '(^|: )(fatal )?error:',
+				color = red,
+				error = true
 			},
 			warning = {
-				searchString = 'warning:',
+				pattern = '(^|: )warning:',
 				color = yellow
 			},
 			note = {
-				searchString = 'note:',
+				pattern = '(^|: )note:',
 				color = blue
 			},
 			unimplemented = {
 				searchString = 'sorry, unimplemented:',
-				color = red
+				color = red,
+				error = true
 			},
 			-- ld.
 			requiredFrom = {
@@ -52,11 +77,13 @@ coloring_tee_config = {
 			},
 			fatal = {
 				searchString = 'fatal:',
-				color = red
+				color = red,
+				error = true
 			},
 			undefined_reference = { 
 				searchString = ': undefined reference',
-				color = red
+				color = red,
+				error = true
 			},
 			inFunction = {
 				searchString = ': In function',
@@ -64,7 +91,8 @@ coloring_tee_config = {
 			},
 			multipleDefinitions = {
 				searchString = ': multiple definition',
-				color = red
+				color = red,
+				error = true
 			},
 			firstDefinedHere = {
 				searchString = ': first defined here',
@@ -72,12 +100,14 @@ coloring_tee_config = {
 			},
 			cannotFind = {
 				searchString = ': cannot find',
-				color = red
+				color = red,
+				error = true
 			},
 			-- Makefile.
 			no_rule_to_make_target = {
 				searchString = '*** No rule to make target',
-				color = red
+				color = red,
+				error = true
 			},
 			-- ndk-build.
 			WARNING = {
@@ -86,29 +116,38 @@ coloring_tee_config = {
 			},
 		},
 		logcat = {
+			-- Level is after date and time from "adb logcat -v time".
 			verbose = { 
 				searchString = 'V/',
+				field = 3,
 				color = white
 			},
 			debug = { 
 				searchString = 'D/',
+				field = 3,
 				color = blue
 			},
 			info = { 
 				searchString = 'I/',
+				field = 3,
 				color = green
 			},
 			warning = { 
 				searchString = 'W/',
+				field = 3,
 				color = yellow
 			},
 			error = { 
 				searchString = 'E/',
-				color = red
+				field = 3,
+				color = red,
+				error = true
 			},
 			fatal = { 
 				searchString = 'F/',
-				color = red
+				field = 3,
+				color = red,
+				error = true
 			},
 		},
 		bracket = {
@@ -130,15 +169,18 @@ coloring_tee_config = {
 			},
 			error = { 
 				searchString = '[error]',
-				color = red
+				color = red,
+				error = true
 			},
 			critical = { 
 				searchString = '[critical]',
-				color = red
+				color = red,
+				error = true
 			},
 			fatal = { 
 				searchString = '[fatal]',
-				color = red
+				color = red,
+				error = true
 			},
 		},
 		modelsim = {
@@ -152,7 +194,8 @@ coloring_tee_config = {
 			},
 			error = { 
 				searchString = '** Error:',
-				color = red
+				color = red,
+				error = true
 			},
 		},	
 	}
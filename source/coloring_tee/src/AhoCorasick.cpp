@@ -0,0 +1,109 @@
+/**
+ * @file AhoCorasick.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Aho-Corasick automaton for matching many strings in one pass.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AhoCorasick.h"
+
+#include <map>
+#include <deque>
+#include <algorithm>
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+
+const int32_t AhoCorasick::NO_MATCH;
+
+AhoCorasick::AhoCorasick()
+		: _classCount(1), _delta(1, 0), _output(1, NO_MATCH),
+		_bestPossible(NO_MATCH) {
+	memset(_byteClass, 0, sizeof(_byteClass));
+}
+
+void AhoCorasick::add(const std::string& pattern, int priority) {
+	Pattern p;
+	p.pattern = pattern;
+	p.priority = priority;
+	_patterns.push_back(p);
+}
+
+void AhoCorasick::compile() {
+	using namespace std;
+
+	// Bytes not used in any pattern all go to class 0.
+	memset(_byteClass, 0, sizeof(_byteClass));
+	_classCount = 1;
+	for(const Pattern& p: _patterns){
+		for(char c: p.pattern){
+			uint8_t b = c;
+			if(!_byteClass[b]){
+				_byteClass[b] = _classCount++;
+			}
+		}
+	}
+
+	// Build trie.
+	vector<map<uint8_t, int32_t> > trie(1);
+	_output.assign(1, NO_MATCH);
+	_bestPossible = NO_MATCH;
+	for(const Pattern& p: _patterns){
+		int32_t state = 0;
+		for(char c: p.pattern){
+			uint8_t cls = _byteClass[uint8_t(c)];
+			auto iter = trie[state].find(cls);
+			if(iter == trie[state].end()){
+				int32_t newState = trie.size();
+				trie[state][cls] = newState;
+				trie.push_back(map<uint8_t, int32_t>());
+				_output.push_back(NO_MATCH);
+				state = newState;
+			}else{
+				state = iter->second;
+			}
+		}
+		_output[state] = min(_output[state], p.priority);
+		_bestPossible = min(_bestPossible, p.priority);
+	}
+
+	// Breadth first over trie, making full transition table
+	// from goto and failure functions.
+	_delta.assign(trie.size()*_classCount, 0);
+	vector<int32_t> fail(trie.size(), 0);
+	deque<int32_t> queue;
+	for(auto& edge: trie[0]){
+		_delta[edge.first] = edge.second;
+		queue.push_back(edge.second);
+	}
+	while(!queue.empty()){
+		int32_t state = queue.front();
+		queue.pop_front();
+		int32_t f = fail[state];
+		// Patterns ending in failure state also end here.
+		_output[state] = min(_output[state], _output[f]);
+		for(int32_t cls = 0; cls < _classCount; cls++){
+			auto iter = trie[state].find(cls);
+			if(iter != trie[state].end()){
+				int32_t child = iter->second;
+				fail[child] = _delta[f*_classCount + cls];
+				_delta[state*_classCount + cls] = child;
+				queue.push_back(child);
+			}else{
+				_delta[state*_classCount + cls] = _delta[f*_classCount + cls];
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,109 @@
+/**
+ * @file AhoCorasick.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Aho-Corasick automaton for matching many strings in one pass.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef AHOCORASICK_H_
+#define AHOCORASICK_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CommonMacros.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class AhoCorasick
+ * @brief Multi string matcher. Every pattern have priority,
+ * lower number is higher priority, and find() returns priority of
+ * best pattern found anywhere in text.
+ */
+class AhoCorasick {
+public:
+	AhoCorasick();
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Add pattern. Must be called before compile().
+	 * @param pattern string to search for.
+	 * @param priority non-negative priority, lower is better.
+	 */
+	void add(const std::string& pattern, int priority);
+
+	/**
+	 * Build automaton from added patterns.
+	 */
+	void compile();
+
+	bool empty() const noexcept {
+		return _patterns.empty();
+	}
+
+	/**
+	 * Find best priority pattern in text.
+	 * @param text text to search.
+	 * @param size size of text.
+	 * @return priority of found pattern or -1 if nothing is found.
+	 */
+	int find(const char* text, size_t size) const noexcept {
+		const uint8_t* s = reinterpret_cast<const uint8_t*>(text);
+		const uint8_t* end = s + size;
+		const int32_t* delta = &_delta[0];
+		const int32_t* output = &_output[0];
+		int32_t state = 0;
+		int32_t best = output[0];
+		for(; s != end; s++){
+			state = delta[state*_classCount + _byteClass[*s]];
+			int32_t o = output[state];
+			if(o < best){
+				best = o;
+				if(best == _bestPossible){
+					break;
+				}
+			}
+		}
+		return best == NO_MATCH ? -1 : best;
+	}
+
+	///////////////////////////////////
+
+protected:
+	static const int32_t NO_MATCH = INT32_MAX;
+
+	class Pattern {
+	public:
+		std::string pattern;
+		int32_t priority;
+	};
+
+	std::vector<Pattern> _patterns;
+
+	uint16_t _byteClass[256];
+	int32_t _classCount;
+	/// Transitions, indexed by state*_classCount + byte class.
+	std::vector<int32_t> _delta;
+	/// Best priority of all patterns ending in state.
+	std::vector<int32_t> _output;
+	int32_t _bestPossible;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // AHOCORASICK_H_
@@ -0,0 +1,101 @@
+/**
+ * @file BatchQueue.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Bounded queue of line batches between two pipeline stages.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef BATCHQUEUE_H_
+#define BATCHQUEUE_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+#include "CommonMacros.h"
+#include "stl_extensions/mpmc_ring.h"
+
+#include "LineBatch.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class BatchQueue
+ * @brief Bounded queue of batches with one producer. Usually there is
+ * one consumer, but producer could also take oldest batch out,
+ * when it drops batches for slow sink, so it is lock-free ring
+ * for many consumers. Waiting side spins shortly and then sleeps
+ * on futex, so there is no system call while both sides are busy.
+ * Null batch is used to mark end of stream.
+ */
+class BatchQueue {
+public:
+	/**
+	 * @param capacity maximal number of batches in queue,
+	 * rounded up to power of 2.
+	 */
+	explicit BatchQueue(size_t capacity = 64)
+			: _ring(capacity) {
+	}
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Put batch to queue, waiting while queue is full.
+	 */
+	void push(const LineBatchPtr& batch) {
+		_ring.push(batch);
+	}
+
+	/**
+	 * Put batch to queue if it is not full.
+	 * @return false if queue is full.
+	 */
+	bool tryPush(const LineBatchPtr& batch) {
+		return _ring.try_push(batch);
+	}
+
+	/**
+	 * Take batch from queue, waiting while queue is empty.
+	 */
+	LineBatchPtr pop() {
+		LineBatchPtr batch;
+		_ring.pop(batch);
+		return batch;
+	}
+
+	/**
+	 * Take batch from queue if it is not empty.
+	 * @return false if queue is empty.
+	 */
+	bool tryPop(LineBatchPtr& batch) {
+		return _ring.try_pop(batch);
+	}
+
+	/**
+	 * Take batch from queue, waiting at most given time.
+	 * @param ms time to wait in milliseconds.
+	 * @return false if queue is still empty.
+	 */
+	bool popFor(LineBatchPtr& batch, int ms) {
+		return _ring.pop_for(batch, ms);
+	}
+
+	///////////////////////////////////
+
+protected:
+	stl_extensions::mpmc_ring<LineBatchPtr> _ring;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // BATCHQUEUE_H_
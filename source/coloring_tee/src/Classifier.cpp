@@ -0,0 +1,86 @@
+/**
+ * @file Classifier.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Finding which rule colors line.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Classifier.h"
+
+using namespace ostream_color_log;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @return better of two found priorities, where -1 is nothing found.
+ */
+static inline int betterFound(int a, int b){
+	if(a < 0){
+		return b;
+	}
+	if(b < 0){
+		return a;
+	}
+	return a < b ? a : b;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Classifier::Classifier(size_t dfaCacheSize)
+		: _regexMatcher(dfaCacheSize), _regexAlways(false) {
+}
+
+void Classifier::compile(const std::vector<SearchStringToColor>& rules) {
+	for(size_t i = 0; i < rules.size(); i++){
+		const SearchStringToColor& rule = rules[i];
+		if(rule.isPattern){
+			std::string literal = _regexMatcher.add(rule.searchString, i);
+			if(literal.empty()){
+				_regexAlways = true;
+			}else{
+				_prefilter.add(literal);
+			}
+		}else if(rule.position >= 0){
+			_positionalMatcher.add(rule.searchString,
+					PositionalMatcher::Position(rule.position), rule.index, i);
+		}else{
+			_matcher.add(rule.searchString, i);
+			_prefilter.add(rule.searchString);
+		}
+	}
+	_matcher.compile();
+	_prefilter.compile();
+	_regexMatcher.compile();
+	_positionalMatcher.compile();
+}
+
+int Classifier::classify(const char* text, size_t size) {
+	// Checking few bytes on known position is cheapest.
+	int found = -1;
+	if(!_positionalMatcher.empty()){
+		found = _positionalMatcher.find(text, size);
+	}
+	// Most lines match nothing, so reject them quickly.
+	bool candidate = _prefilter.candidate(text, size);
+	if(candidate && !_matcher.empty()){
+		found = betterFound(found, _matcher.find(text, size));
+	}
+	// Regex is slower, so skip it if it could not win.
+	if((candidate || _regexAlways) && !_regexMatcher.empty()
+			&& (found < 0 || found > _regexMatcher.bestPossible())){
+		found = betterFound(found, _regexMatcher.find(text, size));
+	}
+	return found;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,119 @@
+/**
+ * @file Classifier.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Finding which rule colors line.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef CLASSIFIER_H_
+#define CLASSIFIER_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "CommonMacros.h"
+#include "ostream_color_log/text_style.h"
+
+#include "AhoCorasick.h"
+#include "Prefilter.h"
+#include "LazyDfa.h"
+#include "PositionalMatcher.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SearchStringToColor{
+public:
+	/// Plain string or regular expression.
+	std::string searchString;
+	bool isPattern;
+	/// PositionalMatcher::Position or -1 if string could be anywhere.
+	int position;
+	/// Column or field number.
+	int index;
+	ostream_color_log::text_color color;
+	ostream_color_log::text_color background;
+	/// Id of whole style in style_registry.
+	size_t style;
+	/// Line is counted as error in index of paged HTML.
+	bool error;
+	/// Rule with higher priority goes first in list.
+	int priority;
+
+public:
+	SearchStringToColor(const std::string& searchString_, bool isPattern_)
+			: searchString(searchString_), isPattern(isPattern_),
+			position(-1), index(0), style(0), error(false), priority(0){
+	}
+};
+
+///////////////////////////////////////
+
+/**
+ * @class Classifier
+ * @brief All matchers of enabled rules together.
+ * Priority of rule is its index, so first rule in list wins.
+ */
+class Classifier {
+public:
+	/**
+	 * @param dfaCacheSize maximal memory for regex DFA states, in bytes.
+	 */
+	explicit Classifier(size_t dfaCacheSize = 2 << 20);
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Build matchers from rules.
+	 * @param rules rules in priority order.
+	 * @throw RegexError if some pattern is not valid.
+	 */
+	void compile(const std::vector<SearchStringToColor>& rules);
+
+	/**
+	 * @param text line to classify.
+	 * @param size size of line.
+	 * @return index of rule coloring line or -1 if none does.
+	 */
+	int classify(const char* text, size_t size);
+
+	///////////////////////////////////
+
+public:
+	const char* prefilterImplementation() const noexcept {
+		return _prefilter.implementation();
+	}
+
+	size_t dfaStates() const noexcept {
+		return _regexMatcher.cachedStates();
+	}
+
+	size_t dfaCacheFlushes() const noexcept {
+		return _regexMatcher.cacheFlushes();
+	}
+
+	///////////////////////////////////
+
+protected:
+	AhoCorasick _matcher;
+	Prefilter _prefilter;
+	LazyDfa _regexMatcher;
+	PositionalMatcher _positionalMatcher;
+	/// Patterns without required literal must be tried on every line.
+	bool _regexAlways;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // CLASSIFIER_H_
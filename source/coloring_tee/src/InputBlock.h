@@ -0,0 +1,81 @@
+/**
+ * @file InputBlock.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Refcounted piece of input which lines point to.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef INPUTBLOCK_H_
+#define INPUTBLOCK_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <memory>
+
+#include "CommonMacros.h"
+#include "stl_extensions/mmapped_file.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class InputBlock
+ * @brief Memory which input is read to, or mapping of input file.
+ * Batches point to lines in block and keep it alive, so lines
+ * go from input to every output without copying. Block is freed
+ * at once when last batch pointing to it is gone,
+ * that is when all sinks wrote it out.
+ */
+class InputBlock {
+public:
+	/**
+	 * Block of memory to read input to.
+	 */
+	explicit InputBlock(size_t size)
+			: _memory(new char[size]), _data(_memory.get()), _size(size) {
+	}
+
+	/**
+	 * Block with whole mapped file, which is not written to.
+	 */
+	explicit InputBlock(const stl_extensions::mmapped_file& mapping)
+			: _mapping(mapping),
+			_data(reinterpret_cast<char*>(mapping.get_mapped_memory())),
+			_size(mapping.get_file_size()) {
+	}
+
+	InputBlock(const InputBlock&) = delete;
+	const InputBlock& operator=(const InputBlock&) = delete;
+
+	char* data() noexcept {
+		return _data;
+	}
+
+	const char* data() const noexcept {
+		return _data;
+	}
+
+	size_t size() const noexcept {
+		return _size;
+	}
+
+protected:
+	std::unique_ptr<char[]> _memory;
+	stl_extensions::mmapped_file _mapping;
+	char* _data;
+	size_t _size;
+};
+
+typedef std::shared_ptr<InputBlock> InputBlockPtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // INPUTBLOCK_H_
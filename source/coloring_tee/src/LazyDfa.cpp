@@ -0,0 +1,761 @@
+/**
+ * @file LazyDfa.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Regular expressions matched with lazily built DFA.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LazyDfa.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define MAX_REPETITION 1000
+#define MAX_NFA_STATES 100000
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class RegexParser
+ * @brief Parse pattern to syntax tree and compile tree to NFA states
+ * of LazyDfa.
+ */
+class RegexParser {
+public:
+	RegexParser(LazyDfa& dfa, const std::string& pattern)
+			: _dfa(dfa), _pattern(pattern), _pos(0) {
+	}
+
+	/**
+	 * @param priority priority of pattern.
+	 * @param start NFA state from which pattern starts.
+	 * @return literal which must be in every matched text, could be empty.
+	 */
+	std::string parse(int32_t priority, int32_t& start) {
+		int32_t root = parseAlternation();
+		if(_pos != _pattern.size()){
+			error("Unmatched )");
+		}
+		int32_t match = _dfa.addNfaState(LazyDfa::NfaState::MATCH, -1);
+		_dfa._nfa[match].priority = priority;
+		start = compile(root, match);
+		return requiredLiteral(root);
+	}
+
+	///////////////////////////////////
+
+protected:
+	class Node {
+	public:
+		enum Type {
+			CHARS,
+			CONCAT,
+			ALT,
+			REPEAT,
+			BOL,
+			EOL
+		};
+
+		Type type;
+		std::bitset<256> chars;
+		std::vector<int32_t> children;
+		int min;
+		int max; // Negative for infinity.
+	};
+
+	///////////////////////////////////
+
+	[[noreturn]] void error(const char* message) {
+		throw RegexError() << message << " at position " << _pos
+				<< " in pattern \"" << _pattern << "\"" << endl;
+	}
+
+	int32_t newNode(Node::Type type) {
+		Node n;
+		n.type = type;
+		n.min = n.max = 0;
+		_nodes.push_back(n);
+		return _nodes.size() - 1;
+	}
+
+	bool end() const {
+		return _pos == _pattern.size();
+	}
+
+	char peek() const {
+		return _pattern[_pos];
+	}
+
+	int32_t parseAlternation() {
+		int32_t first = parseConcatenation();
+		if(end() || peek() != '|'){
+			return first;
+		}
+		int32_t alt = newNode(Node::ALT);
+		_nodes[alt].children.push_back(first);
+		while(!end() && peek() == '|'){
+			_pos++;
+			int32_t next = parseConcatenation();
+			_nodes[alt].children.push_back(next);
+		}
+		return alt;
+	}
+
+	int32_t parseConcatenation() {
+		int32_t concat = newNode(Node::CONCAT);
+		while(!end() && peek() != '|' && peek() != ')'){
+			int32_t next = parseRepetition();
+			_nodes[concat].children.push_back(next);
+		}
+		return concat;
+	}
+
+	int32_t parseRepetition() {
+		int32_t atom = parseAtom();
+		while(!end()){
+			int min, max;
+			char c = peek();
+			if(c == '*'){
+				min = 0;
+				max = -1;
+				_pos++;
+			}else if(c == '+'){
+				min = 1;
+				max = -1;
+				_pos++;
+			}else if(c == '?'){
+				min = 0;
+				max = 1;
+				_pos++;
+			}else if(c == '{' && parseBound(min, max)){
+			}else{
+				break;
+			}
+			// Lazy quantifier does not change if line matches.
+			if(!end() && peek() == '?'){
+				_pos++;
+			}
+			Node::Type type = _nodes[atom].type;
+			if(type == Node::BOL || type == Node::EOL){
+				error("Repeating anchor");
+			}
+			int32_t repeat = newNode(Node::REPEAT);
+			_nodes[repeat].children.push_back(atom);
+			_nodes[repeat].min = min;
+			_nodes[repeat].max = max;
+			atom = repeat;
+		}
+		return atom;
+	}
+
+	/**
+	 * Parse {n}, {n,} or {n,m}.
+	 * @return false if it is not bound, then "{" is literal.
+	 */
+	bool parseBound(int& min, int& max) {
+		size_t pos = _pos + 1;
+		size_t digits = pos;
+		min = 0;
+		while(pos < _pattern.size() && isdigit(uint8_t(_pattern[pos]))){
+			min = std::min(min*10 + (_pattern[pos++] - '0'),
+					MAX_REPETITION + 1);
+		}
+		if(pos == digits){
+			return false;
+		}
+		max = min;
+		if(pos < _pattern.size() && _pattern[pos] == ','){
+			pos++;
+			max = -1;
+			if(pos < _pattern.size() && isdigit(uint8_t(_pattern[pos]))){
+				max = 0;
+				while(pos < _pattern.size() && isdigit(uint8_t(_pattern[pos]))){
+					max = std::min(max*10 + (_pattern[pos++] - '0'),
+							MAX_REPETITION + 1);
+				}
+			}
+		}
+		if(pos == _pattern.size() || _pattern[pos] != '}'){
+			return false;
+		}
+		_pos = pos + 1;
+		if(min > MAX_REPETITION || max > MAX_REPETITION){
+			error("Too big repetition");
+		}
+		if(max >= 0 && max < min){
+			error("Bad repetition bounds");
+		}
+		return true;
+	}
+
+	int32_t parseAtom() {
+		char c = peek();
+		switch(c){
+		case '(':{
+			_pos++;
+			// Non capturing group is same, nothing is captured.
+			if(_pattern.compare(_pos, 2, "?:") == 0){
+				_pos += 2;
+			}
+			int32_t group = parseAlternation();
+			if(end() || peek() != ')'){
+				error("Missing )");
+			}
+			_pos++;
+			return group;
+		}
+		case '*':
+		case '+':
+		case '?':
+			error("Nothing to repeat");
+		case '^':
+			_pos++;
+			return newNode(Node::BOL);
+		case '$':
+			_pos++;
+			return newNode(Node::EOL);
+		case '.':{
+			_pos++;
+			int32_t any = newNode(Node::CHARS);
+			_nodes[any].chars.set();
+			return any;
+		}
+		case '[':{
+			_pos++;
+			int32_t bracket = newNode(Node::CHARS);
+			std::bitset<256> chars;
+			parseBracket(chars);
+			_nodes[bracket].chars = chars;
+			return bracket;
+		}
+		case '\\':{
+			_pos++;
+			int32_t escaped = newNode(Node::CHARS);
+			std::bitset<256> chars;
+			parseEscape(chars);
+			_nodes[escaped].chars = chars;
+			return escaped;
+		}
+		default:{
+			_pos++;
+			int32_t literal = newNode(Node::CHARS);
+			_nodes[literal].chars.set(uint8_t(c));
+			return literal;
+		}
+		}
+	}
+
+	static int firstChar(const std::bitset<256>& chars) {
+		int c = 0;
+		while(c < 255 && !chars[c]){
+			c++;
+		}
+		return c;
+	}
+
+	static void setRange(std::bitset<256>& chars, int first, int last) {
+		for(int c = first; c <= last; c++){
+			chars.set(c);
+		}
+	}
+
+	/**
+	 * Parse escape after "\".
+	 * @return false if escape is class like \\d which could not be end
+	 * of range in bracket expression.
+	 */
+	bool parseEscape(std::bitset<256>& chars) {
+		if(end()){
+			error("Trailing \\");
+		}
+		char c = _pattern[_pos++];
+		std::bitset<256> set;
+		bool single = false;
+		switch(c){
+		case 'd':
+		case 'D':
+			setRange(set, '0', '9');
+			break;
+		case 'w':
+		case 'W':
+			setRange(set, '0', '9');
+			setRange(set, 'a', 'z');
+			setRange(set, 'A', 'Z');
+			set.set('_');
+			break;
+		case 's':
+		case 'S':
+			set.set(' ');
+			setRange(set, '\t', '\r');
+			break;
+		case 't':
+			set.set('\t');
+			single = true;
+			break;
+		case 'n':
+			set.set('\n');
+			single = true;
+			break;
+		case 'r':
+			set.set('\r');
+			single = true;
+			break;
+		case 'x':{
+			int value = 0;
+			for(int i = 0; i < 2; i++){
+				if(end() || !isxdigit(uint8_t(peek()))){
+					error("Bad \\x escape");
+				}
+				char h = _pattern[_pos++];
+				value = value*16
+						+ (isdigit(uint8_t(h)) ? h - '0' : tolower(h) - 'a' + 10);
+			}
+			set.set(value);
+			single = true;
+			break;
+		}
+		default:
+			if(isalnum(uint8_t(c))){
+				error("Unsupported escape");
+			}
+			set.set(uint8_t(c));
+			single = true;
+			break;
+		}
+		if(c == 'D' || c == 'W' || c == 'S'){
+			set.flip();
+		}
+		chars |= set;
+		return single;
+	}
+
+	void parseBracket(std::bitset<256>& chars) {
+		bool negate = false;
+		if(!end() && peek() == '^'){
+			negate = true;
+			_pos++;
+		}
+		bool first = true;
+		while(true){
+			if(end()){
+				error("Missing ]");
+			}
+			char c = peek();
+			if(c == ']' && !first){
+				_pos++;
+				break;
+			}
+			first = false;
+
+			int low;
+			if(c == '[' && _pattern.compare(_pos, 2, "[:") == 0){
+				size_t close = _pattern.find(":]", _pos + 2);
+				if(close == std::string::npos){
+					error("Missing :]");
+				}
+				std::string name = _pattern.substr(_pos + 2, close - _pos - 2);
+				_pos = close + 2;
+				parseClassName(name, chars);
+				continue;
+			}else if(c == '\\'){
+				_pos++;
+				std::bitset<256> escaped;
+				if(!parseEscape(escaped)){
+					chars |= escaped;
+					continue;
+				}
+				low = firstChar(escaped);
+			}else{
+				low = uint8_t(c);
+				_pos++;
+			}
+
+			// Range, but "-" before "]" is literal.
+			if(_pos + 1 < _pattern.size() && peek() == '-'
+					&& _pattern[_pos + 1] != ']'){
+				_pos++;
+				int high;
+				if(peek() == '\\'){
+					_pos++;
+					std::bitset<256> escaped;
+					if(!parseEscape(escaped)){
+						error("Bad range");
+					}
+					high = firstChar(escaped);
+				}else{
+					high = uint8_t(peek());
+					_pos++;
+				}
+				if(high < low){
+					error("Bad range");
+				}
+				setRange(chars, low, high);
+			}else{
+				chars.set(low);
+			}
+		}
+		if(negate){
+			chars.flip();
+		}
+	}
+
+	void parseClassName(const std::string& name, std::bitset<256>& chars) {
+		int (*is)(int);
+		if(name == "alpha"){
+			is = isalpha;
+		}else if(name == "digit"){
+			is = isdigit;
+		}else if(name == "alnum"){
+			is = isalnum;
+		}else if(name == "space"){
+			is = isspace;
+		}else if(name == "upper"){
+			is = isupper;
+		}else if(name == "lower"){
+			is = islower;
+		}else if(name == "punct"){
+			is = ispunct;
+		}else if(name == "xdigit"){
+			is = isxdigit;
+		}else{
+			error("Unknown character class");
+		}
+		for(int c = 0; c < 128; c++){
+			if(is(c)){
+				chars.set(c);
+			}
+		}
+	}
+
+	///////////////////////////////////
+
+	/**
+	 * Compile node to NFA states.
+	 * @param node node of syntax tree.
+	 * @param out NFA state where to go after node is matched.
+	 * @return NFA state where node matching starts.
+	 */
+	int32_t compile(int32_t node, int32_t out) {
+		typedef LazyDfa::NfaState NfaState;
+
+		if(_dfa._nfa.size() > MAX_NFA_STATES){
+			error("Pattern too big");
+		}
+
+		const Node& n = _nodes[node];
+		switch(n.type){
+		case Node::CHARS:{
+			int32_t s = _dfa.addNfaState(NfaState::CHARS, out);
+			_dfa._nfa[s].chars = n.chars;
+			return s;
+		}
+		case Node::CONCAT:
+			for(size_t i = n.children.size(); i > 0; i--){
+				out = compile(n.children[i-1], out);
+			}
+			return out;
+		case Node::ALT:{
+			int32_t entry = compile(n.children.back(), out);
+			for(size_t i = n.children.size() - 1; i > 0; i--){
+				int32_t alternative = compile(n.children[i-1], out);
+				entry = _dfa.addNfaState(NfaState::SPLIT, alternative, entry);
+			}
+			return entry;
+		}
+		case Node::REPEAT:{
+			int32_t child = n.children[0];
+			int min = n.min;
+			int max = n.max;
+			int32_t entry = out;
+			if(max < 0){
+				int32_t loop = _dfa.addNfaState(NfaState::SPLIT, -1, out);
+				int32_t body = compile(child, loop);
+				_dfa._nfa[loop].out = body;
+				entry = loop;
+			}else{
+				for(int i = min; i < max; i++){
+					int32_t body = compile(child, entry);
+					entry = _dfa.addNfaState(NfaState::SPLIT, body, out);
+				}
+			}
+			for(int i = 0; i < min; i++){
+				entry = compile(child, entry);
+			}
+			return entry;
+		}
+		case Node::BOL:
+			return _dfa.addNfaState(NfaState::BOL, out);
+		case Node::EOL:
+			return _dfa.addNfaState(NfaState::EOL, out);
+		}
+		return out;
+	}
+
+	/**
+	 * Longest run of single characters in top level concatenation.
+	 */
+	std::string requiredLiteral(int32_t root) {
+		std::string best;
+		const Node& n = _nodes[root];
+		if(n.type != Node::CONCAT){
+			return best;
+		}
+		std::string current;
+		for(int32_t child: n.children){
+			const Node& c = _nodes[child];
+			if(c.type == Node::CHARS && c.chars.count() == 1){
+				current += char(firstChar(c.chars));
+			}else if(c.type == Node::BOL || c.type == Node::EOL){
+				// Anchors take no characters.
+			}else{
+				current.clear();
+			}
+			if(current.size() > best.size()){
+				best = current;
+			}
+		}
+		return best;
+	}
+
+	///////////////////////////////////
+
+protected:
+	LazyDfa& _dfa;
+	const std::string& _pattern;
+	size_t _pos;
+	std::vector<Node> _nodes;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+const int32_t LazyDfa::NO_MATCH;
+const int32_t LazyDfa::UNKNOWN;
+
+LazyDfa::LazyDfa(size_t cacheSize)
+		: _bestPossible(NO_MATCH), _classCount(1), _beginState(0),
+		_emptyLineMatch(NO_MATCH),
+		_cacheSize(cacheSize), _cacheUsed(0), _cacheFlushes(0),
+		_visitMark(0) {
+	memset(_byteClass, 0, sizeof(_byteClass));
+}
+
+std::string LazyDfa::add(const std::string& pattern, int priority) {
+	RegexParser parser(*this, pattern);
+	int32_t start;
+	std::string literal = parser.parse(priority, start);
+	_starts.push_back(start);
+	_bestPossible = std::min(_bestPossible, int32_t(priority));
+	return literal;
+}
+
+void LazyDfa::compile() {
+	using namespace std;
+
+	// Bytes are in same class if every CHARS state treats them same.
+	vector<string> signatures(256);
+	for(const NfaState& s: _nfa){
+		if(s.type == NfaState::CHARS){
+			for(int c = 0; c < 256; c++){
+				signatures[c] += s.chars[c] ? '1' : '0';
+			}
+		}
+	}
+	map<string, int32_t> classes;
+	_classRepresentative.clear();
+	for(int c = 0; c < 256; c++){
+		auto iter = classes.find(signatures[c]);
+		if(iter == classes.end()){
+			int32_t cls = classes.size();
+			classes[signatures[c]] = cls;
+			_classRepresentative.push_back(c);
+			_byteClass[c] = cls;
+		}else{
+			_byteClass[c] = iter->second;
+		}
+	}
+	_classCount = classes.size();
+
+	_visited.assign(_nfa.size(), 0);
+	_visitMark = 0;
+
+	std::vector<int32_t> unused;
+	_emptyLineMatch = closure(_starts, true, true, unused);
+
+	_cacheFlushes = 0;
+	flushCache();
+	_cacheFlushes = 0;
+}
+
+int LazyDfa::find(const char* text, size_t size) {
+	if(_starts.empty()){
+		return -1;
+	}
+	if(size == 0){
+		return _emptyLineMatch == NO_MATCH ? -1 : _emptyLineMatch;
+	}
+	const uint8_t* s = reinterpret_cast<const uint8_t*>(text);
+	int32_t state = _beginState;
+	int32_t best = _dfa[state].match;
+	for(size_t i = 0; i < size && best != _bestPossible; i++){
+		int32_t byteClass = _byteClass[s[i]];
+		int32_t next = _transitions[state*_classCount + byteClass];
+		if(next == UNKNOWN){
+			next = transition(state, byteClass);
+		}
+		state = next;
+		best = std::min(best, _dfa[state].match);
+	}
+	best = std::min(best, _dfa[state].eolMatch);
+	return best == NO_MATCH ? -1 : best;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int32_t LazyDfa::addNfaState(NfaState::Type type, int32_t out,
+		int32_t out1) {
+	NfaState s;
+	s.type = type;
+	s.out = out;
+	s.out1 = out1;
+	s.priority = NO_MATCH;
+	_nfa.push_back(s);
+	return _nfa.size() - 1;
+}
+
+int32_t LazyDfa::closure(const std::vector<int32_t>& seeds, bool atBegin,
+		bool atEnd, std::vector<int32_t>& set) {
+	set.clear();
+	if(++_visitMark == 0){
+		std::fill(_visited.begin(), _visited.end(), 0);
+		_visitMark = 1;
+	}
+
+	int32_t best = NO_MATCH;
+	_stack.assign(seeds.begin(), seeds.end());
+	while(!_stack.empty()){
+		int32_t s = _stack.back();
+		_stack.pop_back();
+		if(_visited[s] == _visitMark){
+			continue;
+		}
+		_visited[s] = _visitMark;
+
+		const NfaState& state = _nfa[s];
+		switch(state.type){
+		case NfaState::CHARS:
+			set.push_back(s);
+			break;
+		case NfaState::SPLIT:
+			_stack.push_back(state.out1);
+			_stack.push_back(state.out);
+			break;
+		case NfaState::BOL:
+			if(atBegin){
+				_stack.push_back(state.out);
+			}
+			break;
+		case NfaState::EOL:
+			if(atEnd){
+				_stack.push_back(state.out);
+			}else{
+				set.push_back(s);
+			}
+			break;
+		case NfaState::MATCH:
+			best = std::min(best, state.priority);
+			break;
+		}
+	}
+	std::sort(set.begin(), set.end());
+	return best;
+}
+
+int32_t LazyDfa::addDfaState(const std::vector<int32_t>& set,
+		int32_t match) {
+	// Same NFA states entered with different match are different states.
+	std::vector<int32_t> key(set);
+	key.push_back(match);
+	auto iter = _dfaIds.find(key);
+	if(iter != _dfaIds.end()){
+		return iter->second;
+	}
+
+	DfaState d;
+	d.nfa = set;
+	d.match = match;
+	std::vector<int32_t> eolSeeds;
+	for(int32_t s: set){
+		if(_nfa[s].type == NfaState::EOL){
+			eolSeeds.push_back(_nfa[s].out);
+		}
+	}
+	d.eolMatch = NO_MATCH;
+	if(!eolSeeds.empty()){
+		std::vector<int32_t> unused;
+		d.eolMatch = closure(eolSeeds, false, true, unused);
+	}
+
+	int32_t id = _dfa.size();
+	_dfa.push_back(d);
+	_transitions.resize(_transitions.size() + _classCount, UNKNOWN);
+	_dfaIds[key] = id;
+	// Rough memory of state, its key in map and its transitions.
+	_cacheUsed += sizeof(DfaState) + 64
+			+ 2*(set.size() + 1)*sizeof(int32_t)
+			+ _classCount*sizeof(int32_t);
+	return id;
+}
+
+int32_t LazyDfa::transition(int32_t state, int32_t byteClass) {
+	uint8_t c = _classRepresentative[byteClass];
+
+	// Pattern could start on every position.
+	std::vector<int32_t> seeds(_starts);
+	for(int32_t s: _dfa[state].nfa){
+		const NfaState& n = _nfa[s];
+		if(n.type == NfaState::CHARS && n.chars[c]){
+			seeds.push_back(n.out);
+		}
+	}
+	std::vector<int32_t> set;
+	int32_t match = closure(seeds, false, false, set);
+
+	if(_cacheUsed > _cacheSize){
+		// Old state is gone, so transition is not remembered.
+		flushCache();
+		return addDfaState(set, match);
+	}
+
+	int32_t next = addDfaState(set, match);
+	_transitions[state*_classCount + byteClass] = next;
+	return next;
+}
+
+void LazyDfa::flushCache() {
+	_dfa.clear();
+	_dfaIds.clear();
+	_transitions.clear();
+	_cacheUsed = 0;
+	_cacheFlushes++;
+
+	// Begin state differs from others only in passing BOL states,
+	// after that it is same as other state with same NFA states.
+	std::vector<int32_t> set;
+	int32_t match = closure(_starts, true, false, set);
+	_beginState = addDfaState(set, match);
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,212 @@
+/**
+ * @file LazyDfa.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Regular expressions matched with lazily built DFA.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef LAZYDFA_H_
+#define LAZYDFA_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <bitset>
+
+#include "CommonMacros.h"
+#include "Exceptions.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class RegexError
+ * @brief Error in regular expression.
+ */
+class RegexError : public Exception {
+public:
+	explicit RegexError()
+			: Exception("RegexError") {
+	}
+	explicit RegexError(const std::string& message)
+			: Exception("RegexError", message) {
+	}
+};
+
+///////////////////////////////////////
+
+/**
+ * @class LazyDfa
+ * @brief Many regular expressions combined into one automaton.
+ *
+ * Supported syntax is subset of POSIX extended regular expressions:
+ * literals, ".", bracket expressions with ranges and [:class:] names,
+ * \\d \\w \\s \\D \\W \\S \\t \\xHH escapes, groups, "|",
+ * "*", "+", "?", {n}, {n,}, {n,m}, and "^", "$" anchors.
+ * Matching is done on bytes.
+ *
+ * Patterns are compiled to one NFA. DFA states are made from it only
+ * when text reach them, so matching is linear in text size and there is
+ * no backtracking. When made states take more memory than cache size,
+ * all states are thrown away and building starts again.
+ */
+class LazyDfa {
+public:
+	/**
+	 * @param cacheSize maximal memory taken by DFA states, in bytes.
+	 */
+	explicit LazyDfa(size_t cacheSize = 2 << 20);
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Parse and add pattern. Must be called before compile().
+	 * @param pattern regular expression.
+	 * @param priority non-negative priority, lower is better.
+	 * @return literal which must be in every line matched by pattern,
+	 * empty if there is no such literal.
+	 * @throw RegexError if pattern is not valid.
+	 */
+	std::string add(const std::string& pattern, int priority);
+
+	/**
+	 * Prepare automaton for matching.
+	 */
+	void compile();
+
+	bool empty() const noexcept {
+		return _starts.empty();
+	}
+
+	/**
+	 * @return best priority of all patterns.
+	 */
+	int bestPossible() const noexcept {
+		return _bestPossible;
+	}
+
+	/**
+	 * Find best priority pattern matching anywhere in text.
+	 * @param text text to search.
+	 * @param size size of text.
+	 * @return priority of matched pattern or -1 if nothing matched.
+	 */
+	int find(const char* text, size_t size);
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * @return number of DFA states now in cache.
+	 */
+	size_t cachedStates() const noexcept {
+		return _dfa.size();
+	}
+
+	/**
+	 * @return how many times cache was full and thrown away.
+	 */
+	size_t cacheFlushes() const noexcept {
+		return _cacheFlushes;
+	}
+
+	///////////////////////////////////
+
+protected:
+	static const int32_t NO_MATCH = INT32_MAX;
+	static const int32_t UNKNOWN = -1;
+
+	class NfaState {
+	public:
+		enum Type {
+			CHARS, // Consume byte from set and go to out.
+			SPLIT, // Go to both out and out1.
+			BOL, // Go to out at begin of line.
+			EOL, // Go to out at end of line.
+			MATCH // Pattern with priority matched.
+		};
+
+		Type type;
+		int32_t out;
+		int32_t out1;
+		int32_t priority;
+		std::bitset<256> chars;
+	};
+
+	class DfaState {
+	public:
+		/// Sorted CHARS and EOL NFA states.
+		std::vector<int32_t> nfa;
+		/// Best priority matched when entering state.
+		int32_t match;
+		/// Best priority matched if line ends in state.
+		int32_t eolMatch;
+	};
+
+	friend class RegexParser;
+
+	int32_t addNfaState(NfaState::Type type, int32_t out,
+			int32_t out1 = -1);
+
+	/**
+	 * Epsilon closure of seeds.
+	 * @param seeds NFA states.
+	 * @param atBegin if BOL could be passed.
+	 * @param atEnd if EOL could be passed.
+	 * @param set resulting CHARS and EOL states, sorted.
+	 * @return best priority of MATCH states found.
+	 */
+	int32_t closure(const std::vector<int32_t>& seeds, bool atBegin,
+			bool atEnd, std::vector<int32_t>& set);
+
+	int32_t addDfaState(const std::vector<int32_t>& set, int32_t match);
+	int32_t transition(int32_t state, int32_t byteClass);
+	void flushCache();
+
+	///////////////////////////////////
+
+protected:
+	std::vector<NfaState> _nfa;
+	/// Start state of every pattern.
+	std::vector<int32_t> _starts;
+	int32_t _bestPossible;
+
+	uint16_t _byteClass[256];
+	int32_t _classCount;
+	/// One byte from every class.
+	std::vector<uint8_t> _classRepresentative;
+
+	std::vector<DfaState> _dfa;
+	std::map<std::vector<int32_t>, int32_t> _dfaIds;
+	/// Transitions, indexed by state*_classCount + byte class.
+	std::vector<int32_t> _transitions;
+	/// State at begin of line.
+	int32_t _beginState;
+	/// Best priority matched by empty line, which is both begin and end.
+	int32_t _emptyLineMatch;
+
+	size_t _cacheSize;
+	size_t _cacheUsed;
+	size_t _cacheFlushes;
+
+	// For closure().
+	std::vector<uint32_t> _visited;
+	uint32_t _visitMark;
+	std::vector<int32_t> _stack;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // LAZYDFA_H_
@@ -0,0 +1,158 @@
+/**
+ * @file LineBatch.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Lines passed between pipeline stages.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef LINEBATCH_H_
+#define LINEBATCH_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "CommonMacros.h"
+
+#include "InputBlock.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class LineRecord
+ * @brief One line in LineBatch.
+ */
+class LineRecord {
+public:
+	/// Offset of line in LineBatch::text(),
+	/// batch is full long before it could overflow.
+	uint32_t offset;
+	/// Index of rule which colors line or -1 if line is not colored.
+	int32_t found;
+	/// Size of line without new line character after it.
+	size_t size;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class LineBatch
+ * @brief Many lines passed between stages with one queue operation.
+ * Lines are not copied, batch points to them in input block,
+ * where they are one after another and every line is followed by
+ * new line character, so uncolored output is whole text at once.
+ * Batch keeps block alive, and block is freed when all batches
+ * pointing to it are written by all sinks.
+ */
+class LineBatch {
+public:
+	/// Batch is full when it have that many bytes.
+	static const size_t MAX_DATA = 64 << 10;
+	/// Batch is full when it have that many lines.
+	static const size_t MAX_LINES = 1024;
+
+	LineBatch()
+			: spilled(0), idle(false), sequence(0), _text(0), _textSize(0) {
+		lines.reserve(MAX_LINES);
+	}
+
+	/**
+	 * Empty batch telling sink to read batches from its spill file.
+	 * @param spilled number of batches to read.
+	 */
+	explicit LineBatch(size_t spilled)
+			: spilled(spilled), idle(false), sequence(0), _text(0),
+			_textSize(0) {
+	}
+
+	/**
+	 * Add line without copying it.
+	 * @param block block which line is in, batch keeps it alive.
+	 * @param line line which must be followed by new line character.
+	 * @return false if line is not right after previous one
+	 * in same block, then line must go to new batch.
+	 */
+	bool add(const InputBlockPtr& block, const char* line, size_t size) {
+		if(lines.empty()){
+			_block = block;
+			_text = line;
+		}else if(block != _block || line != _text + _textSize){
+			return false;
+		}
+		LineRecord r;
+		r.offset = line - _text;
+		r.found = -1;
+		r.size = size;
+		_textSize += size + 1;
+		lines.push_back(r);
+		return true;
+	}
+
+	/**
+	 * Set text which lines are already recorded for.
+	 * @param block block which text is in, batch keeps it alive.
+	 */
+	void setText(const InputBlockPtr& block, const char* text, size_t size) {
+		_block = block;
+		_text = text;
+		_textSize = size;
+	}
+
+	bool full() const noexcept {
+		return _textSize >= MAX_DATA || lines.size() >= MAX_LINES;
+	}
+
+	bool empty() const noexcept {
+		return lines.empty();
+	}
+
+	const char* line(size_t i) const noexcept {
+		return _text + lines[i].offset;
+	}
+
+	/**
+	 * @return all lines, each followed by new line character.
+	 */
+	const char* text() const noexcept {
+		return _text;
+	}
+
+	size_t textSize() const noexcept {
+		return _textSize;
+	}
+
+	std::vector<LineRecord> lines;
+	/// Number of batches in spill file which go before this batch.
+	size_t spilled;
+	/// Input had nothing more when batch was sent,
+	/// so interactive outputs should show it now.
+	bool idle;
+	/// Number of batch in input, counting from 0.
+	size_t sequence;
+	/// Text rendered by workers, once for every kind of rendering
+	/// of sinks, shared by sinks of same kind.
+	std::vector<std::string> rendered;
+
+protected:
+	InputBlockPtr _block;
+	const char* _text;
+	size_t _textSize;
+};
+
+typedef std::shared_ptr<LineBatch> LineBatchPtr;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // LINEBATCH_H_
@@ -0,0 +1,260 @@
+/**
+ * @file LineReader.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Chunked raw input reader, splitting input to lines.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LineReader.h"
+
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <poll.h>
+#include <sys/stat.h>
+
+#include "Exceptions.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+LineReader::LineReader(int fd, size_t blockSize)
+		: _fd(fd), _blockSize(blockSize),
+		_block(std::make_shared<InputBlock>(blockSize)),
+		_begin(0), _end(0), _scanned(0),
+		_eof(false), _error(0), _interruptFd(-1), _interrupted(false),
+		_tee(0), _mapBegin(0), _mapEnd(0), _mapPos(0), _mapCheck(0) {
+}
+
+bool LineReader::map() {
+	struct stat s;
+	if(fstat(_fd, &s) || !S_ISREG(s.st_mode)){
+		return false;
+	}
+	try{
+		_mapping.open(_fd, "input");
+	}catch(const Exception&){
+		return false;
+	}
+	if(!_mapping.get_mapped_memory()){
+		// Empty file, but read it, maybe something appends to it.
+		return false;
+	}
+	_mapping.advise_sequential();
+	_block = std::make_shared<InputBlock>(_mapping);
+	_mapBegin = _block->data();
+	// Reading continues from file offset, like read(2) would,
+	// so nothing is left from offset at or after end of file.
+	off_t offset = lseek(_fd, 0, SEEK_CUR);
+	if(offset < 0){
+		offset = 0;
+	}
+	_mapPos = _mapBegin + std::min<off_t>(offset, s.st_size);
+	_mapEnd = _mapBegin + _mapping.get_file_size();
+	_mapCheck = _mapPos;
+	return true;
+}
+
+bool LineReader::next(Line& line) {
+	if(_mapBegin){
+		return nextMapped(line);
+	}
+	while(true){
+		// memchr() is vectorized in glibc, so scanning is at memory speed.
+		const char* begin = _block->data() + _begin;
+		const char* newLine = static_cast<const char*>(memchr(
+				begin + _scanned,
+				'\n',
+				_end - _begin - _scanned));
+		if(newLine){
+			line.data = begin;
+			line.size = newLine - begin;
+			_begin += line.size + 1;
+			_scanned = 0;
+			return true;
+		}
+		_scanned = _end - _begin;
+
+		if(!fill()){
+			if(_begin == _end){
+				return false;
+			}
+			// Last line without new line, so one is put after it.
+			if(_end == _block->size()){
+				newBlock(1);
+			}
+			_block->data()[_end] = '\n';
+			line.data = _block->data() + _begin;
+			line.size = _end - _begin;
+			_end++;
+			_begin = _end;
+			_scanned = 0;
+			return true;
+		}
+	}
+}
+
+bool LineReader::nextMapped(Line& line) {
+	if(_mapPos == _mapEnd){
+		return false;
+	}
+	// Nothing waits for input, so check interrupt from time to time.
+	if(_interruptFd >= 0 && _mapPos >= _mapCheck){
+		_mapCheck = _mapPos + (1 << 20);
+		struct pollfd fds;
+		fds.fd = _interruptFd;
+		fds.events = POLLIN;
+		if(poll(&fds, 1, 0) > 0){
+			_interrupted = true;
+			_mapPos = _mapEnd;
+			return false;
+		}
+	}
+	const char* newLine = static_cast<const char*>(memchr(
+			_mapPos,
+			'\n',
+			_mapEnd - _mapPos));
+	line.data = _mapPos;
+	if(newLine){
+		line.size = newLine - _mapPos;
+		_mapPos = newLine + 1;
+	}else{
+		// Last line without new line, copied to block with new line.
+		line.size = _mapEnd - _mapPos;
+		_block = std::make_shared<InputBlock>(line.size + 1);
+		memcpy(_block->data(), _mapPos, line.size);
+		_block->data()[line.size] = '\n';
+		line.data = _block->data();
+		_mapPos = _mapEnd;
+	}
+	return true;
+}
+
+bool LineReader::buffered() {
+	if(_mapBegin){
+		return true;
+	}
+	if(_eof){
+		return true;
+	}
+	const char* begin = _block->data() + _begin;
+	const char* newLine = static_cast<const char*>(memchr(
+			begin + _scanned,
+			'\n',
+			_end - _begin - _scanned));
+	if(newLine){
+		// next() will find it again without scanning.
+		_scanned = newLine - begin;
+		return true;
+	}
+	_scanned = _end - _begin;
+	return false;
+}
+
+bool LineReader::pending() const {
+	if(_eof || _mapBegin){
+		return false;
+	}
+	struct pollfd fds;
+	fds.fd = _fd;
+	fds.events = POLLIN;
+	return poll(&fds, 1, 0) > 0 && (fds.revents & POLLIN);
+}
+
+bool LineReader::fill() {
+	if(_eof){
+		return false;
+	}
+
+	// Small reads are slow, so with little place left
+	// reading continues in new block.
+	if(_block->size() - _end < _block->size() / 16){
+		newBlock(_block->size() / 16);
+	}
+
+	while(true){
+		if(_interruptFd >= 0){
+			struct pollfd fds[2];
+			fds[0].fd = _fd;
+			fds[0].events = POLLIN;
+			fds[1].fd = _interruptFd;
+			fds[1].events = POLLIN;
+			if(poll(fds, 2, -1) < 0){
+				if(errno == EINTR){
+					continue;
+				}
+				_error = errno;
+				_eof = true;
+				return false;
+			}
+			if(fds[1].revents){
+				_interrupted = true;
+				_eof = true;
+				return false;
+			}
+		}
+		ssize_t r = readSome(_block->size() - _end);
+		if(r > 0){
+			_end += r;
+			return true;
+		}else if(r == 0){
+			_eof = true;
+			return false;
+		}else if(errno != EINTR){
+			_error = errno;
+			_eof = true;
+			return false;
+		}
+	}
+}
+
+void LineReader::newBlock(size_t minSize) {
+	size_t unfinished = _end - _begin;
+	size_t size = _blockSize;
+	// Line longer than half of block gets bigger block.
+	while(size - unfinished < minSize || size < 2*unfinished){
+		size *= 2;
+	}
+	// Batches could still point to lines in old block, so it is
+	// not reused, and it is freed when last of them is gone.
+	InputBlockPtr block = std::make_shared<InputBlock>(size);
+	memcpy(block->data(), _block->data() + _begin, unfinished);
+	_block = block;
+	_begin = 0;
+	_end = unfinished;
+}
+
+ssize_t LineReader::readSome(size_t size) {
+	if(!_tee || _tee->empty()){
+		return read(_fd, _block->data() + _end, size);
+	}
+
+	// Outputs got copy of n bytes, now exactly that much must be read.
+	ssize_t n = _tee->duplicate(size);
+	if(n <= 0){
+		return n;
+	}
+	size_t done = 0;
+	while(done < size_t(n)){
+		ssize_t r = read(_fd, _block->data() + _end + done, n - done);
+		if(r > 0){
+			done += r;
+		}else if(r == 0){
+			break;
+		}else if(errno != EINTR){
+			return done ? ssize_t(done) : r;
+		}
+	}
+	return done;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,196 @@
+/**
+ * @file LineReader.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Chunked raw input reader, splitting input to lines.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef LINEREADER_H_
+#define LINEREADER_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+#include <unistd.h>
+
+#include "CommonMacros.h"
+#include "stl_extensions/mmapped_file.h"
+
+#include "InputBlock.h"
+#include "SpliceTee.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class Line
+ * @brief View to one line in LineReader::block(), without new line
+ * character, which always follows it in block.
+ * Valid as long as block is.
+ */
+class Line {
+public:
+	const char* data;
+	size_t size;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class LineReader
+ * @brief Reads input with big read(2) calls into blocks
+ * and hands out lines as views into them. Block is filled to its end,
+ * and only unfinished line at its end is copied to next block,
+ * so lines handed out stay where they are as long as block is kept.
+ * Regular file could be mapped instead, then lines are views
+ * into mapping and nothing is copied.
+ */
+class LineReader {
+public:
+	/**
+	 * @param fd file descriptor to read from.
+	 * @param blockSize size of block, block is bigger only
+	 * for line longer than half of it.
+	 */
+	explicit LineReader(
+			int fd = STDIN_FILENO,
+			size_t blockSize = 1 << 20);
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Map input if it is regular file. Must be called before next().
+	 * @return false if input could not be mapped, then it is read.
+	 */
+	bool map();
+
+	/**
+	 * @return mapping of input, or NULL if input is read.
+	 * Lines are valid as long as mapping exists.
+	 */
+	const stl_extensions::mmapped_file* mapping() const noexcept {
+		return _mapBegin ? &_mapping : 0;
+	}
+
+	/**
+	 * Get next line. Last line do not need to end with new line,
+	 * reader puts one after it.
+	 * @param line view to line in block().
+	 * @return false on end of input or on error.
+	 */
+	bool next(Line& line);
+
+	/**
+	 * @return block which line from last next() is in.
+	 * Keeping it keeps line valid.
+	 */
+	const InputBlockPtr& block() const noexcept {
+		return _block;
+	}
+
+	/**
+	 * @return true if next() could return without waiting for input.
+	 */
+	bool buffered();
+
+	/**
+	 * @return true if input have data which could be read without waiting.
+	 */
+	bool pending() const;
+
+	/**
+	 * Stop reading when fd become readable, as if input ended.
+	 * Used to wake reader blocked on input, for example from signal
+	 * handler writing to pipe.
+	 * @param fd file descriptor to watch, -1 to not watch any.
+	 */
+	void setInterruptFd(int fd) noexcept {
+		_interruptFd = fd;
+	}
+
+	/**
+	 * Copy every input chunk to splice outputs before reading it.
+	 * @param tee outputs getting input as it is, NULL for none.
+	 */
+	void setTee(SpliceTee* tee) noexcept {
+		_tee = tee;
+	}
+
+	/**
+	 * @return errno of read error or 0 if input ended normally.
+	 */
+	int error() const noexcept {
+		return _error;
+	}
+
+	/**
+	 * @return true if reading was stopped with interrupt fd.
+	 */
+	bool interrupted() const noexcept {
+		return _interrupted;
+	}
+
+	///////////////////////////////////
+
+protected:
+	/**
+	 * Read more data to block. Unfinished line goes to new block first,
+	 * if block have not enough place left.
+	 * @return false if nothing more could be read.
+	 */
+	bool fill();
+
+	/**
+	 * Start new block with unfinished line, which is copied to its begin.
+	 * @param minSize place needed in block.
+	 */
+	void newBlock(size_t minSize);
+
+	/**
+	 * next() for mapped input.
+	 */
+	bool nextMapped(Line& line);
+
+	/**
+	 * Read up to size bytes after data in block.
+	 * @return same as read(2).
+	 */
+	ssize_t readSome(size_t size);
+
+	///////////////////////////////////
+
+protected:
+	int _fd;
+	size_t _blockSize;
+	InputBlockPtr _block;
+	/// Unconsumed data in block.
+	size_t _begin;
+	size_t _end;
+	// Part of [_begin, _end) already searched for new line.
+	size_t _scanned;
+	bool _eof;
+	int _error;
+	int _interruptFd;
+	bool _interrupted;
+	SpliceTee* _tee;
+	stl_extensions::mmapped_file _mapping;
+	const char* _mapBegin;
+	const char* _mapEnd;
+	/// Next line in mapping.
+	const char* _mapPos;
+	/// Where mapped input checks interrupt fd next time.
+	const char* _mapCheck;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // LINEREADER_H_
@@ -120,6 +120,19 @@ int LuaConfig::getFieldInt(const char *key) {
 	return result;
 }
 
+bool LuaConfig::getFieldBool(const char *key) {
+	assert(L);
+	lua_getfield(L, -1, key);
+	if(!lua_isboolean(L, -1)){
+		lua_pop(L, 1);
+		throw LuaConfigError() << EXCEPTION_FROM_HERE
+				<< "Field \"" << key << "\" is not a boolean!" << endl;
+	}
+	bool result = lua_toboolean(L, -1);
+	lua_pop(L, 1);
+	return result;
+}
+
 double LuaConfig::getFieldDouble(const char *key) {
 	assert(L);
 	lua_getfield(L, -1, key);
@@ -117,6 +117,12 @@ public:
 	 * @return read integer.
 	 */
 	int getFieldInt(const char* key);
+	/**
+	 * Read boolean from table on top of Lua stack.
+	 * @param key for access a table.
+	 * @return read boolean.
+	 */
+	bool getFieldBool(const char* key);
 	/**
 	 * Read double from table on top of Lua stack.
 	 * @param key for access a table.
@@ -0,0 +1,265 @@
+/**
+ * @file Pipeline.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Reading, classifying and writing lines in separate threads.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Pipeline.h"
+
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+
+Pipeline::Pipeline(LineReader& reader, Classifier* classifier,
+		size_t workers)
+		: _reader(reader), _lineCount(0), _coloredCount(0) {
+	if(workers < 1){
+		workers = 1;
+	}
+	// Together workers hold about as many batches as one queue did,
+	// but every queue holds at least 2, so many workers do not stall.
+	size_t capacity = std::max<size_t>(2, 64 / workers);
+	for(size_t i = 0; i < workers; i++){
+		_classifiers.push_back(i == 0 || !classifier
+				? classifier : new Classifier(*classifier));
+		_workQueues.push_back(new BatchQueue(capacity));
+		_doneQueues.push_back(new BatchQueue(capacity));
+	}
+}
+
+Pipeline::~Pipeline() {
+	for(SinkStage* stage: _sinks){
+		delete stage;
+	}
+	for(size_t i = 0; i < _workQueues.size(); i++){
+		if(i != 0){
+			delete _classifiers[i];
+		}
+		delete _workQueues[i];
+		delete _doneQueues[i];
+	}
+}
+
+size_t Pipeline::dfaStates() const noexcept {
+	// Every worker builds its own DFA.
+	size_t states = 0;
+	for(const Classifier* classifier: _classifiers){
+		if(classifier){
+			states += classifier->dfaStates();
+		}
+	}
+	return states;
+}
+
+size_t Pipeline::dfaCacheFlushes() const noexcept {
+	size_t flushes = 0;
+	for(const Classifier* classifier: _classifiers){
+		if(classifier){
+			flushes += classifier->dfaCacheFlushes();
+		}
+	}
+	return flushes;
+}
+
+int Pipeline::addSink(Sink* sink, const std::string& name,
+		QueuePolicy policy, const FlushPolicy& flush) {
+	SinkStage* stage = new SinkStage(sink, name, policy, flush);
+	_sinks.push_back(stage);
+	std::string key = sink->renderKey();
+	if(!key.empty()){
+		size_t i = 0;
+		while(i < _renderKeys.size() && _renderKeys[i] != key){
+			i++;
+		}
+		if(i == _renderKeys.size()){
+			_renderers.push_back(sink);
+			_renderKeys.push_back(key);
+		}
+		stage->rendering = i;
+	}
+	if(policy == SPILL_TO_DISK){
+		return stage->spill.open();
+	}
+	return 0;
+}
+
+void Pipeline::run() {
+	std::vector<thread*> threads;
+	StageCall read(this, &Pipeline::readStage, 0);
+	threads.push_back(new thread(read));
+	for(size_t i = 0; i < _workQueues.size(); i++){
+		StageCall work(this, &Pipeline::workStage, i);
+		threads.push_back(new thread(work));
+	}
+	StageCall deliver(this, &Pipeline::deliverStage, 0);
+	threads.push_back(new thread(deliver));
+	for(size_t i = 0; i < _sinks.size(); i++){
+		StageCall sink(this, &Pipeline::sinkStage, i);
+		threads.push_back(new thread(sink));
+	}
+
+	for(thread* t: threads){
+		t->join();
+		delete t;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Pipeline::readStage(size_t) {
+	size_t sequence = 0;
+	LineBatchPtr batch = std::make_shared<LineBatch>();
+	Line line;
+	// Batch goes to next worker in turn.
+	auto send = [&]() {
+		batch->sequence = sequence;
+		_workQueues[sequence % _workQueues.size()]->push(batch);
+		sequence++;
+		batch = std::make_shared<LineBatch>();
+	};
+	while(_reader.next(line)){
+		// Lines are not copied, batch points to them in input block.
+		if(!batch->add(_reader.block(), line.data, line.size)){
+			send();
+			batch->add(_reader.block(), line.data, line.size);
+		}
+		if(batch->full()){
+			send();
+		}else if(!_reader.buffered() && !_reader.pending()){
+			// Do not hold lines while waiting for more input.
+			batch->idle = true;
+			send();
+		}
+	}
+	if(!batch->empty()){
+		send();
+	}
+	for(BatchQueue* queue: _workQueues){
+		queue->push(LineBatchPtr());
+	}
+}
+
+void Pipeline::workStage(size_t worker) {
+	BatchQueue& in = *_workQueues[worker];
+	BatchQueue& out = *_doneQueues[worker];
+	Classifier* classifier = _classifiers[worker];
+	while(LineBatchPtr batch = in.pop()){
+		if(classifier){
+			for(size_t i = 0; i < batch->lines.size(); i++){
+				LineRecord& r = batch->lines[i];
+				r.found = classifier->classify(batch->line(i), r.size);
+			}
+		}
+		batch->rendered.resize(_renderers.size());
+		for(size_t i = 0; i < _renderers.size(); i++){
+			_renderers[i]->render(*batch, batch->rendered[i]);
+		}
+		out.push(batch);
+	}
+	out.push(LineBatchPtr());
+}
+
+void Pipeline::deliverStage(size_t) {
+	for(size_t sequence = 0; ; sequence++){
+		LineBatchPtr batch =
+				_doneQueues[sequence % _doneQueues.size()]->pop();
+		// All sinks share same batch.
+		for(SinkStage* stage: _sinks){
+			deliver(*stage, batch);
+		}
+		if(!batch){
+			break;
+		}
+		_lineCount += batch->lines.size();
+		for(const LineRecord& r: batch->lines){
+			_coloredCount += r.found >= 0;
+		}
+	}
+}
+
+void Pipeline::deliver(SinkStage& stage, const LineBatchPtr& batch) {
+	if(!batch || stage.policy == BLOCK || stage.spillError){
+		// Spilled batches go before this one.
+		if(stage.pendingSpilled){
+			stage.queue.push(std::make_shared<LineBatch>(stage.pendingSpilled));
+			stage.pendingSpilled = 0;
+		}
+		stage.queue.push(batch);
+	}else if(stage.policy == DROP_OLDEST){
+		while(!stage.queue.tryPush(batch)){
+			LineBatchPtr oldest;
+			if(stage.queue.tryPop(oldest)){
+				stage.droppedLines += oldest->lines.size();
+			}
+		}
+	}else{
+		// Once something is spilled, everything goes to spill file until
+		// queue have place for batch telling sink to read it,
+		// so order is kept.
+		if(stage.pendingSpilled && stage.queue.tryPush(
+				std::make_shared<LineBatch>(stage.pendingSpilled))){
+			stage.pendingSpilled = 0;
+		}
+		if(!stage.pendingSpilled && stage.queue.tryPush(batch)){
+			return;
+		}
+		stage.spillError = stage.spill.write(*batch);
+		if(stage.spillError){
+			// Cannot spill, so from now wait as block policy does.
+			deliver(stage, batch);
+			return;
+		}
+		stage.pendingSpilled++;
+		stage.spilledLines += batch->lines.size();
+	}
+}
+
+void Pipeline::sinkStage(size_t sink) {
+	SinkStage& stage = *_sinks[sink];
+	const FlushPolicy& flush = stage.flush;
+	LineBatchPtr batch = stage.queue.pop();
+	while(batch){
+		for(size_t i = 0; i < batch->spilled; i++){
+			LineBatchPtr spilled = stage.spill.read();
+			if(spilled){
+				// Rendered text is not spilled.
+				stage.sink->write(spilled);
+			}
+			if(stage.sink->pending() >= flush.size){
+				stage.sink->flush();
+			}
+		}
+		if(stage.rendering < batch->rendered.size()){
+			stage.sink->writeRendered(batch,
+					batch->rendered[stage.rendering]);
+		}else{
+			stage.sink->write(batch);
+		}
+		if((flush.lineBuffered && batch->idle)
+				|| stage.sink->pending() >= flush.size){
+			stage.sink->flush();
+		}
+
+		// Buffered lines wait for next batch only for idle time.
+		if(!stage.sink->pending()){
+			batch = stage.queue.pop();
+		}else if(!stage.queue.popFor(batch, flush.idleMs)){
+			stage.sink->flush();
+			batch = stage.queue.pop();
+		}
+	}
+	stage.sink->flush();
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,267 @@
+/**
+ * @file Pipeline.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Reading, classifying and writing lines in separate threads.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include "CommonMacros.h"
+#include "thread.h"
+
+#include "LineReader.h"
+#include "LineBatch.h"
+#include "BatchQueue.h"
+#include "Classifier.h"
+#include "Sinks.h"
+#include "SpillFile.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class Pipeline
+ * @brief Reader thread puts lines to batches, worker threads find
+ * rule for every line and every sink have thread writing batches to it.
+ * Batches are given to workers in turn and taken back in same turn,
+ * so sinks get them in input order. Workers also render batches
+ * for sinks which could render in parallel, once for every kind
+ * of rendering, and sinks of same kind write same rendered text.
+ * Stages are connected with bounded queues, so slow sink holds only
+ * its own stage until its queue is full. Then queue policy of sink
+ * decides if classifier waits for it, drops its oldest batches or
+ * spills batches to disk.
+ * Batch is sent further as soon as reader would wait for input,
+ * so interactive output is not delayed. Sinks buffer batches
+ * and write them out as their flush policy says.
+ */
+class Pipeline {
+public:
+	/**
+	 * What to do with batch when sink queue is full.
+	 */
+	enum QueuePolicy {
+		/// Wait until sink takes some batch.
+		BLOCK,
+		/// Throw away oldest batch in queue.
+		DROP_OLDEST,
+		/// Write batch to temporary file, sink reads it later.
+		SPILL_TO_DISK
+	};
+
+	/**
+	 * @class FlushPolicy
+	 * @brief When buffered output of sink is written out.
+	 * Terminal shows batch as soon as input have nothing more,
+	 * everything else is written when enough is buffered,
+	 * or when no new batch came for some time.
+	 */
+	class FlushPolicy {
+	public:
+		/**
+		 * @param lineBuffered write out batch after which input was idle,
+		 * for terminals.
+		 * @param size write out when that many bytes are buffered.
+		 * @param idleMs write out when no batch came for that many ms.
+		 */
+		FlushPolicy(bool lineBuffered = false, size_t size = 1 << 18,
+				int idleMs = 100)
+				: lineBuffered(lineBuffered), size(size), idleMs(idleMs) {
+		}
+
+		bool lineBuffered;
+		size_t size;
+		int idleMs;
+	};
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * @param reader input.
+	 * @param classifier matcher of rules or NULL if lines are not colored.
+	 * @param workers number of worker threads.
+	 */
+	Pipeline(LineReader& reader, Classifier* classifier, size_t workers = 1);
+	~Pipeline();
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Add sink. Must be called before run().
+	 * @param sink sink, not owned.
+	 * @param name name of sink for messages.
+	 * @param policy what to do when sink queue is full.
+	 * @param flush when sink writes out buffered lines.
+	 * @return errno of failure to create spill file or 0.
+	 */
+	int addSink(Sink* sink, const std::string& name,
+			QueuePolicy policy = BLOCK, const FlushPolicy& flush = FlushPolicy());
+
+	/**
+	 * Start all stages and wait until all input is written to all sinks.
+	 */
+	void run();
+
+	size_t lineCount() const noexcept {
+		return _lineCount;
+	}
+
+	size_t coloredCount() const noexcept {
+		return _coloredCount;
+	}
+
+	/**
+	 * @return number of cached DFA states of all workers together.
+	 */
+	size_t dfaStates() const noexcept;
+
+	/**
+	 * @return number of DFA cache flushes of all workers together.
+	 */
+	size_t dfaCacheFlushes() const noexcept;
+
+	size_t sinkCount() const noexcept {
+		return _sinks.size();
+	}
+
+	const std::string& sinkName(size_t sink) const noexcept {
+		return _sinks[sink]->name;
+	}
+
+	/**
+	 * @return number of lines dropped for sink.
+	 */
+	size_t droppedLines(size_t sink) const noexcept {
+		return _sinks[sink]->droppedLines;
+	}
+
+	/**
+	 * @return number of lines which went through spill file of sink.
+	 */
+	size_t spilledLines(size_t sink) const noexcept {
+		return _sinks[sink]->spilledLines;
+	}
+
+	/**
+	 * @return errno of write failure of sink or 0.
+	 */
+	int sinkError(size_t sink) const noexcept {
+		return _sinks[sink]->sink->error();
+	}
+
+	/**
+	 * @return errno of first spill file failure of sink or 0.
+	 */
+	int spillError(size_t sink) const noexcept {
+		return _sinks[sink]->spillError;
+	}
+
+	///////////////////////////////////
+
+protected:
+	/**
+	 * @class SinkStage
+	 * @brief Sink with its queue, policy and counters.
+	 */
+	class SinkStage {
+	public:
+		SinkStage(Sink* sink_, const std::string& name_,
+				QueuePolicy policy_, const FlushPolicy& flush_)
+				: sink(sink_), name(name_), policy(policy_), flush(flush_),
+				rendering(NO_RENDERING), pendingSpilled(0), droppedLines(0),
+				spilledLines(0), spillError(0) {
+		}
+
+		static const size_t NO_RENDERING = size_t(-1);
+
+		Sink* sink;
+		std::string name;
+		QueuePolicy policy;
+		FlushPolicy flush;
+		/// Index of text in LineBatch::rendered which sink writes,
+		/// or NO_RENDERING.
+		size_t rendering;
+		BatchQueue queue;
+		SpillFile spill;
+		/// Batches spilled after last batch put to queue.
+		size_t pendingSpilled;
+		size_t droppedLines;
+		size_t spilledLines;
+		int spillError;
+	};
+
+	void readStage(size_t);
+	void workStage(size_t worker);
+	void deliverStage(size_t);
+	void sinkStage(size_t sink);
+
+	/**
+	 * Give batch to sink queue, as policy of sink says.
+	 * Called only from deliver stage.
+	 */
+	void deliver(SinkStage& stage, const LineBatchPtr& batch);
+
+	/**
+	 * @class StageCall
+	 * @brief Callable for thread, running one stage.
+	 */
+	class StageCall {
+	public:
+		StageCall(Pipeline* pipeline, void (Pipeline::*stage)(size_t),
+				size_t index)
+				: _pipeline(pipeline), _stage(stage), _index(index) {
+		}
+
+		void operator()() {
+			(_pipeline->*_stage)(_index);
+		}
+
+	protected:
+		Pipeline* _pipeline;
+		void (Pipeline::*_stage)(size_t);
+		size_t _index;
+	};
+
+	///////////////////////////////////
+
+protected:
+	LineReader& _reader;
+	/// Classifier for every worker, first is one given to constructor
+	/// and others are its copies, since classifier builds its DFA
+	/// while matching. NULL if lines are not colored.
+	std::vector<Classifier*> _classifiers;
+	/// Batches for every worker.
+	std::vector<BatchQueue*> _workQueues;
+	/// Batches done by every worker.
+	std::vector<BatchQueue*> _doneQueues;
+	std::vector<SinkStage*> _sinks;
+	/// Sink rendering every kind of text in LineBatch::rendered,
+	/// first one added with its render key.
+	std::vector<Sink*> _renderers;
+	std::vector<std::string> _renderKeys;
+
+	size_t _lineCount;
+	size_t _coloredCount;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // PIPELINE_H_
@@ -0,0 +1,101 @@
+/**
+ * @file PositionalMatcher.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Matching strings on known position in line.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PositionalMatcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+
+const int PositionalMatcher::MAX_FIELD;
+
+void PositionalMatcher::add(const std::string& pattern, Position position,
+		int index, int priority) {
+	Pattern p;
+	p.pattern = pattern;
+	p.position = position;
+	p.index = index;
+	p.priority = priority;
+	_patterns.push_back(p);
+}
+
+void PositionalMatcher::compile() {
+	std::stable_sort(_patterns.begin(), _patterns.end(),
+			[](const Pattern& a, const Pattern& b){
+				return a.priority < b.priority;
+			});
+}
+
+int PositionalMatcher::find(const char* text, size_t size) const noexcept {
+	// Starts of fields, found only as far as patterns need them.
+	size_t fieldStart[MAX_FIELD];
+	int fieldsFound = 0;
+	size_t fieldScan = 0;
+
+	size_t lineSize = size;
+	if(lineSize > 0 && text[lineSize - 1] == '\r'){
+		lineSize--;
+	}
+
+	for(const Pattern& p: _patterns){
+		size_t n = p.pattern.size();
+		size_t offset;
+		switch(p.position){
+		case START:
+			offset = 0;
+			break;
+		case END:
+			if(n > lineSize){
+				continue;
+			}
+			offset = lineSize - n;
+			break;
+		case COLUMN:
+			offset = p.index - 1;
+			break;
+		case FIELD:
+			while(fieldsFound < p.index && fieldScan < size){
+				while(fieldScan < size
+						&& (text[fieldScan] == ' ' || text[fieldScan] == '\t')){
+					fieldScan++;
+				}
+				if(fieldScan == size){
+					break;
+				}
+				fieldStart[fieldsFound++] = fieldScan;
+				while(fieldScan < size
+						&& text[fieldScan] != ' ' && text[fieldScan] != '\t'){
+					fieldScan++;
+				}
+			}
+			if(fieldsFound < p.index){
+				continue;
+			}
+			offset = fieldStart[p.index - 1];
+			break;
+		default:
+			continue;
+		}
+		if(offset + n <= size && !memcmp(text + offset, p.pattern.data(), n)){
+			return p.priority;
+		}
+	}
+	return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
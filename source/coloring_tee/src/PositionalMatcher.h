@@ -0,0 +1,101 @@
+/**
+ * @file PositionalMatcher.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Matching strings on known position in line.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef POSITIONALMATCHER_H_
+#define POSITIONALMATCHER_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CommonMacros.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class PositionalMatcher
+ * @brief Strings which must be on start or end of line, on some column,
+ * or on start of some field. Fixed format logs, like logcat ones,
+ * have level on same place in every line, so only few bytes are
+ * compared instead of searching whole line.
+ */
+class PositionalMatcher {
+public:
+	enum Position {
+		/// On start of line.
+		START,
+		/// On end of line, ignoring "\r" from CRLF line ending.
+		END,
+		/// On byte column, counting from 1.
+		COLUMN,
+		/// On start of field, counting from 1.
+		/// Fields are separated with spaces and tabs, like in awk.
+		FIELD
+	};
+
+	/// Biggest supported field number.
+	static const int MAX_FIELD = 64;
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Add pattern. Must be called before compile().
+	 * @param pattern string to compare.
+	 * @param position where pattern must be.
+	 * @param index column or field number, not used for START and END.
+	 * @param priority non-negative priority, lower is better.
+	 */
+	void add(const std::string& pattern, Position position, int index,
+			int priority);
+
+	/**
+	 * Prepare for matching.
+	 */
+	void compile();
+
+	bool empty() const noexcept {
+		return _patterns.empty();
+	}
+
+	/**
+	 * Find best priority pattern on its position in text.
+	 * @param text text to check.
+	 * @param size size of text.
+	 * @return priority of found pattern or -1 if nothing is found.
+	 */
+	int find(const char* text, size_t size) const noexcept;
+
+	///////////////////////////////////
+
+protected:
+	class Pattern {
+	public:
+		std::string pattern;
+		Position position;
+		int index;
+		int32_t priority;
+	};
+
+	/// Sorted by priority, so first found is best.
+	std::vector<Pattern> _patterns;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // POSITIONALMATCHER_H_
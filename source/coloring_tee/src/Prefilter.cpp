@@ -0,0 +1,311 @@
+/**
+ * @file Prefilter.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Fast rejection of lines which cannot contain any search string.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Prefilter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Guess how common byte is in build and device logs,
+ * bigger is more common.
+ */
+static int byteCommonness(uint8_t c) {
+	static const char* lowerByFrequency = "etaoinsrhldcumfpgwybvkxjqz";
+	if(c == ' '){
+		return 100;
+	}else if(c >= 'a' && c <= 'z'){
+		return 90 - (strchr(lowerByFrequency, c) - lowerByFrequency);
+	}else if(c >= '0' && c <= '9'){
+		return 70;
+	}else if(c && strchr("./:_-=(),'\"", c)){
+		return 60;
+	}else if(c >= 'A' && c <= 'Z'){
+		return 40;
+	}else{
+		return 20;
+	}
+}
+
+class Fingerprint {
+public:
+	uint8_t first;
+	uint8_t second;
+	bool single;
+
+	bool operator<(const Fingerprint& other) const {
+		if(first != other.first){
+			return first < other.first;
+		}
+		if(single != other.single){
+			return single;
+		}
+		return second < other.second;
+	}
+	bool operator==(const Fingerprint& other) const {
+		return first == other.first && single == other.single
+				&& second == other.second;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+Prefilter::Prefilter()
+		: _candidate(candidateNever), _implementation("none") {
+	memset(_lo0, 0, sizeof(_lo0));
+	memset(_hi0, 0, sizeof(_hi0));
+	memset(_lo1, 0, sizeof(_lo1));
+	memset(_hi1, 0, sizeof(_hi1));
+	memset(_pairs, 0, sizeof(_pairs));
+	memset(_singles, 0, sizeof(_singles));
+}
+
+void Prefilter::add(const std::string& pattern) {
+	_patterns.push_back(pattern);
+}
+
+void Prefilter::compile() {
+	using namespace std;
+
+	memset(_lo0, 0, sizeof(_lo0));
+	memset(_hi0, 0, sizeof(_hi0));
+	memset(_lo1, 0, sizeof(_lo1));
+	memset(_hi1, 0, sizeof(_hi1));
+	memset(_pairs, 0, sizeof(_pairs));
+	memset(_singles, 0, sizeof(_singles));
+
+	if(_patterns.empty()){
+		_candidate = candidateNever;
+		_implementation = "none";
+		return;
+	}
+
+	vector<Fingerprint> fingerprints;
+	for(const string& pattern: _patterns){
+		const uint8_t* s = reinterpret_cast<const uint8_t*>(pattern.data());
+		Fingerprint f;
+		if(pattern.size() == 0){
+			// Empty pattern is found in every line.
+			_candidate = candidateAlways;
+			_implementation = "always";
+			return;
+		}else if(pattern.size() == 1){
+			f.first = s[0];
+			f.second = 0;
+			f.single = true;
+		}else{
+			// Take rarest pair.
+			size_t best = 0;
+			int bestCommonness = 1000;
+			for(size_t i = 0; i + 1 < pattern.size(); i++){
+				int commonness = byteCommonness(s[i])
+						+ byteCommonness(s[i+1]);
+				if(commonness < bestCommonness){
+					bestCommonness = commonness;
+					best = i;
+				}
+			}
+			f.first = s[best];
+			f.second = s[best+1];
+			f.single = false;
+		}
+		fingerprints.push_back(f);
+	}
+
+	// Sorted so fingerprints with same first byte share bucket,
+	// which lowers false positives from mixing nibbles.
+	sort(fingerprints.begin(), fingerprints.end());
+	fingerprints.erase(
+			unique(fingerprints.begin(), fingerprints.end()),
+			fingerprints.end());
+
+	for(size_t i = 0; i < fingerprints.size(); i++){
+		const Fingerprint& f = fingerprints[i];
+		uint8_t bucket = 1 << (i*8/fingerprints.size());
+		_lo0[f.first & 0xf] |= bucket;
+		_hi0[f.first >> 4] |= bucket;
+		if(f.single){
+			for(int n = 0; n < 16; n++){
+				_lo1[n] |= bucket;
+				_hi1[n] |= bucket;
+			}
+			_singles[f.first >> 6] |= uint64_t(1) << (f.first & 63);
+		}else{
+			_lo1[f.second & 0xf] |= bucket;
+			_hi1[f.second >> 4] |= bucket;
+			uint32_t pair = uint32_t(f.first) << 8 | f.second;
+			_pairs[pair >> 6] |= uint64_t(1) << (pair & 63);
+		}
+	}
+
+	_candidate = candidateScalar;
+	_implementation = "scalar";
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")){
+		_candidate = candidateAvx2;
+		_implementation = "avx2";
+	}else if(__builtin_cpu_supports("ssse3")){
+		_candidate = candidateSsse3;
+		_implementation = "ssse3";
+	}
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Prefilter::candidateAlways(const Prefilter&, const uint8_t*, size_t) {
+	return true;
+}
+
+bool Prefilter::candidateNever(const Prefilter&, const uint8_t*, size_t) {
+	return false;
+}
+
+bool Prefilter::candidateScalar(const Prefilter& p,
+		const uint8_t* s, size_t n) {
+	return p.tail(s, 0, n);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * Bucket hits for pairs starting on 16 positions from s.
+ * @return bit mask of positions to be verified.
+ */
+__attribute__((target("ssse3"))) static inline
+uint32_t bucketHits16(const uint8_t* tables, const uint8_t* s) {
+	const __m128i nibble = _mm_set1_epi8(0xf);
+	__m128i v0 = _mm_loadu_si128((const __m128i*)s);
+	__m128i v1 = _mm_loadu_si128((const __m128i*)(s + 1));
+	__m128i m = _mm_and_si128(
+			_mm_shuffle_epi8(_mm_load_si128((const __m128i*)tables),
+					_mm_and_si128(v0, nibble)),
+			_mm_shuffle_epi8(_mm_load_si128((const __m128i*)(tables + 16)),
+					_mm_and_si128(_mm_srli_epi16(v0, 4), nibble)));
+	m = _mm_and_si128(m,
+			_mm_shuffle_epi8(_mm_load_si128((const __m128i*)(tables + 32)),
+					_mm_and_si128(v1, nibble)));
+	m = _mm_and_si128(m,
+			_mm_shuffle_epi8(_mm_load_si128((const __m128i*)(tables + 48)),
+					_mm_and_si128(_mm_srli_epi16(v1, 4), nibble)));
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(m, _mm_setzero_si128()))
+			^ 0xffff;
+}
+
+/**
+ * Bucket hits for pairs starting on 32 positions from s.
+ * @return bit mask of positions to be verified.
+ */
+__attribute__((target("avx2"))) static inline
+uint32_t bucketHits32(const uint8_t* tables, const uint8_t* s) {
+	const __m256i nibble = _mm256_set1_epi8(0xf);
+	__m256i v0 = _mm256_loadu_si256((const __m256i*)s);
+	__m256i v1 = _mm256_loadu_si256((const __m256i*)(s + 1));
+	__m256i m = _mm256_and_si256(
+			_mm256_shuffle_epi8(
+					_mm256_broadcastsi128_si256(
+							_mm_load_si128((const __m128i*)tables)),
+					_mm256_and_si256(v0, nibble)),
+			_mm256_shuffle_epi8(
+					_mm256_broadcastsi128_si256(
+							_mm_load_si128((const __m128i*)(tables + 16))),
+					_mm256_and_si256(_mm256_srli_epi16(v0, 4), nibble)));
+	m = _mm256_and_si256(m,
+			_mm256_shuffle_epi8(
+					_mm256_broadcastsi128_si256(
+							_mm_load_si128((const __m128i*)(tables + 32))),
+					_mm256_and_si256(v1, nibble)));
+	m = _mm256_and_si256(m,
+			_mm256_shuffle_epi8(
+					_mm256_broadcastsi128_si256(
+							_mm_load_si128((const __m128i*)(tables + 48))),
+					_mm256_and_si256(_mm256_srli_epi16(v1, 4), nibble)));
+	return ~uint32_t(_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8(m, _mm256_setzero_si256())));
+}
+
+/*
+ * Both versions step over text in blocks and finish with one block
+ * overlapping previous one, aligned to end of text, so only last byte
+ * is left for scalar check. Second byte of pair is loaded from
+ * one position further, so block needs one byte more than its width.
+ */
+
+__attribute__((target("ssse3")))
+bool Prefilter::candidateSsse3(const Prefilter& p,
+		const uint8_t* s, size_t n) {
+	if(n < 17){
+		return p.tail(s, 0, n);
+	}
+	for(size_t i = 0;; i += 16){
+		if(i + 17 > n){
+			i = n - 17;
+		}
+		for(uint32_t hits = bucketHits16(p._lo0, s + i); hits;
+				hits &= hits - 1){
+			if(p.hit(s, i + __builtin_ctz(hits), n)){
+				return true;
+			}
+		}
+		if(i + 17 == n){
+			return p.hit(s, n - 1, n);
+		}
+	}
+}
+
+__attribute__((target("avx2")))
+bool Prefilter::candidateAvx2(const Prefilter& p,
+		const uint8_t* s, size_t n) {
+	if(n < 33){
+		if(n < 17){
+			return p.tail(s, 0, n);
+		}
+		for(uint32_t hits = bucketHits16(p._lo0, s)
+				| bucketHits16(p._lo0, s + n - 17) << (n - 17);
+				hits; hits &= hits - 1){
+			if(p.hit(s, __builtin_ctz(hits), n)){
+				return true;
+			}
+		}
+		return p.hit(s, n - 1, n);
+	}
+	for(size_t i = 0;; i += 32){
+		if(i + 33 > n){
+			i = n - 33;
+		}
+		for(uint32_t hits = bucketHits32(p._lo0, s + i); hits;
+				hits &= hits - 1){
+			if(p.hit(s, i + __builtin_ctz(hits), n)){
+				return true;
+			}
+		}
+		if(i + 33 == n){
+			return p.hit(s, n - 1, n);
+		}
+	}
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
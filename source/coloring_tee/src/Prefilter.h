@@ -0,0 +1,146 @@
+/**
+ * @file Prefilter.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Fast rejection of lines which cannot contain any search string.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef PREFILTER_H_
+#define PREFILTER_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CommonMacros.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class Prefilter
+ * @brief For every pattern one rare pair of neighbour bytes is chosen
+ * as fingerprint and fingerprints are spread over 8 buckets.
+ * Line is candidate if on some position both bytes hit same bucket,
+ * which is tested with nibble lookup tables, 32 or 16 positions
+ * at once with AVX2 or SSSE3 shuffles. Positions found that way are
+ * verified with exact bitmap of fingerprints, because mixing nibbles
+ * in same bucket gives false hits.
+ * Line could be candidate and still do not contain any pattern,
+ * but line containing pattern is always candidate.
+ */
+class Prefilter {
+public:
+	Prefilter();
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Add pattern. Must be called before compile().
+	 * @param pattern string to search for.
+	 */
+	void add(const std::string& pattern);
+
+	/**
+	 * Build lookup tables from added patterns and choose implementation
+	 * for running CPU.
+	 */
+	void compile();
+
+	/**
+	 * @param text text to check.
+	 * @param size size of text.
+	 * @return false if text surely does not contain any of patterns.
+	 */
+	bool candidate(const char* text, size_t size) const {
+		return _candidate(*this, reinterpret_cast<const uint8_t*>(text),
+				size);
+	}
+
+	/**
+	 * @return name of used implementation.
+	 */
+	const char* implementation() const noexcept {
+		return _implementation;
+	}
+
+	///////////////////////////////////
+
+protected:
+	typedef bool (*CandidateFunction)(const Prefilter& p,
+			const uint8_t* s, size_t n);
+
+	static bool candidateAlways(const Prefilter& p,
+			const uint8_t* s, size_t n);
+	static bool candidateNever(const Prefilter& p,
+			const uint8_t* s, size_t n);
+	static bool candidateScalar(const Prefilter& p,
+			const uint8_t* s, size_t n);
+#if defined(__x86_64__) || defined(__i386__)
+	static bool candidateSsse3(const Prefilter& p,
+			const uint8_t* s, size_t n);
+	static bool candidateAvx2(const Prefilter& p,
+			const uint8_t* s, size_t n);
+#endif
+
+	/**
+	 * Exact check if some fingerprint starts on position i.
+	 */
+	bool hit(const uint8_t* s, size_t i, size_t n) const {
+		if(_singles[s[i] >> 6] & (uint64_t(1) << (s[i] & 63))){
+			return true;
+		}
+		if(i + 1 < n){
+			uint32_t pair = uint32_t(s[i]) << 8 | s[i+1];
+			return _pairs[pair >> 6] & (uint64_t(1) << (pair & 63));
+		}
+		return false;
+	}
+
+	/**
+	 * Scalar check of positions from begin to end of text.
+	 */
+	bool tail(const uint8_t* s, size_t begin, size_t n) const {
+		for(size_t i = begin; i < n; i++){
+			if(hit(s, i, n)){
+				return true;
+			}
+		}
+		return false;
+	}
+
+	///////////////////////////////////
+
+protected:
+	std::vector<std::string> _patterns;
+
+	// Bucket bit masks indexed with low and high nibble
+	// of first and second byte of fingerprint.
+	// Kernels expect them to be one after another.
+	alignas(16) uint8_t _lo0[16];
+	alignas(16) uint8_t _hi0[16];
+	alignas(16) uint8_t _lo1[16];
+	alignas(16) uint8_t _hi1[16];
+
+	// Bitmaps of exact fingerprints.
+	uint64_t _pairs[65536/64];
+	uint64_t _singles[256/64];
+
+	CandidateFunction _candidate;
+	const char* _implementation;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // PREFILTER_H_
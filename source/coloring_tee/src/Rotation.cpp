@@ -0,0 +1,241 @@
+/**
+ * @file Rotation.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Closing output files as segments and compressing them.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Rotation.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+Compressor::Compressor()
+		: _finishing(false), _thread(0), _error(0) {
+	Call call(this);
+	_thread = new thread(call);
+}
+
+Compressor::~Compressor() {
+	finish();
+}
+
+void Compressor::add(const string& file, const vector<string>& obsolete) {
+	unique_lock<mutex> lock(_mutex);
+	Job job;
+	job.file = file;
+	job.obsolete = obsolete;
+	_jobs.push_back(job);
+	_added.notify_one();
+}
+
+void Compressor::finish() {
+	if(!_thread){
+		return;
+	}
+	{
+		unique_lock<mutex> lock(_mutex);
+		_finishing = true;
+		_added.notify_one();
+	}
+	_thread->join();
+	delete _thread;
+	_thread = 0;
+}
+
+void Compressor::run() {
+	for(;;){
+		Job job;
+		{
+			unique_lock<mutex> lock(_mutex);
+			while(_jobs.empty() && !_finishing){
+				_added.wait(lock);
+			}
+			if(_jobs.empty()){
+				return;
+			}
+			job = _jobs.front();
+			_jobs.pop_front();
+		}
+		int err = compress(job.file);
+		if(err && !_error){
+			_error = err;
+			_errorFile = job.file;
+		}
+		for(const string& file: job.obsolete){
+			unlink(file.c_str());
+			unlink((file + ".gz").c_str());
+		}
+	}
+}
+
+int Compressor::compress(const string& file) {
+	int in = open(file.c_str(), O_RDONLY);
+	if(in < 0){
+		return errno;
+	}
+	// Compressed file gets its name only when it is complete.
+	string compressed = file + ".gz";
+	string temporary = compressed + ".tmp";
+	// Fastest level, so compression keeps up with fast logs.
+	gzFile out = gzopen(temporary.c_str(), "wb1");
+	if(!out){
+		int err = errno ? errno : ENOMEM;
+		close(in);
+		return err;
+	}
+	int err = 0;
+	vector<char> buffer(1 << 18);
+	for(;;){
+		ssize_t r = read(in, buffer.data(), buffer.size());
+		if(r < 0){
+			if(errno == EINTR){
+				continue;
+			}
+			err = errno;
+			break;
+		}
+		if(r == 0){
+			break;
+		}
+		if(gzwrite(out, buffer.data(), r) != r){
+			err = errno ? errno : EIO;
+			break;
+		}
+	}
+	if(gzclose(out) != Z_OK && !err){
+		err = errno ? errno : EIO;
+	}
+	close(in);
+	if(!err && rename(temporary.c_str(), compressed.c_str())){
+		err = errno;
+	}
+	if(err){
+		// Segment stays as it is.
+		unlink(temporary.c_str());
+		return err;
+	}
+	unlink(file.c_str());
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Rotator::Rotator(const string& name, const RotationPolicy& policy,
+		Compressor* compressor)
+		: _name(name), _policy(policy), _compressor(compressor),
+		_oldest(1), _segment(0), _written(0), _start(time(0)), _error(0) {
+	// Number goes before .html, so segment is still opened in browser.
+	_prefix = _name + ".";
+	if(_name.size() > 5 && _name.compare(_name.size() - 5, 5, ".html") == 0){
+		_prefix = _name.substr(0, _name.size() - 4);
+		_suffix = ".html";
+	}
+	findSegments();
+	// Appended file already have some size.
+	struct stat st;
+	if(stat(_name.c_str(), &st) == 0){
+		_written = st.st_size;
+	}
+}
+
+bool Rotator::due(size_t size) const {
+	if(!_written){
+		// No empty segments.
+		return false;
+	}
+	return (_policy.size && _written + size > _policy.size)
+			|| (_policy.interval && time(0) - _start >= _policy.interval);
+}
+
+int Rotator::rotate(const function<int()>& reopen) {
+	string file = segmentName(_segment + 1);
+	int err = 0;
+	if(rename(_name.c_str(), file.c_str())){
+		err = errno;
+	}else if((err = reopen())){
+		rename(file.c_str(), _name.c_str());
+	}
+	if(err){
+		// Writer goes on with same file, and tries again later.
+		if(!_error){
+			_error = err;
+		}
+		_start = time(0);
+		return err;
+	}
+	_segment++;
+	_written = 0;
+	_start = time(0);
+	vector<string> obsolete;
+	if(_policy.keep){
+		for(; _oldest + _policy.keep <= _segment; _oldest++){
+			obsolete.push_back(segmentName(_oldest));
+		}
+	}
+	_compressor->add(file, obsolete);
+	return 0;
+}
+
+string Rotator::segmentName(size_t segment) const {
+	char number[32];
+	snprintf(number, sizeof(number), "%04zu", segment);
+	return _prefix + number + _suffix;
+}
+
+void Rotator::findSegments() {
+	size_t slash = _prefix.rfind('/');
+	string directory = slash == string::npos
+			? "." : _prefix.substr(0, slash + 1);
+	string base = _prefix.substr(slash + 1);
+	DIR* dir = opendir(directory.c_str());
+	if(!dir){
+		return;
+	}
+	size_t oldest = 0;
+	while(struct dirent* entry = readdir(dir)){
+		string file = entry->d_name;
+		if(file.compare(0, base.size(), base) != 0){
+			continue;
+		}
+		// Number, suffix and maybe .gz after it.
+		const char* p = file.c_str() + base.size();
+		char* end;
+		size_t segment = strtoul(p, &end, 10);
+		string rest = end;
+		if(end == p || *p < '0' || *p > '9'
+				|| (rest != _suffix && rest != _suffix + ".gz")){
+			continue;
+		}
+		if(!oldest || segment < oldest){
+			oldest = segment;
+		}
+		if(segment > _segment){
+			_segment = segment;
+		}
+	}
+	closedir(dir);
+	_oldest = oldest ? oldest : _segment + 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
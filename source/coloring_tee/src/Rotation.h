@@ -0,0 +1,235 @@
+/**
+ * @file Rotation.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Closing output files as segments and compressing them.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef ROTATION_H_
+#define ROTATION_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+
+#include "CommonMacros.h"
+#include "thread.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class RotationPolicy
+ * @brief When output file is closed as segment and new file
+ * is started under its name, and how many segments are kept.
+ */
+class RotationPolicy {
+public:
+	/**
+	 * @param size rotate when file have that many bytes, 0 for no limit.
+	 * @param interval rotate when file is that many seconds old,
+	 * 0 for no limit.
+	 * @param keep number of segments kept, 0 for all.
+	 */
+	RotationPolicy(size_t size = 0, time_t interval = 0, size_t keep = 0)
+			: size(size), interval(interval), keep(keep) {
+	}
+
+	bool enabled() const {
+		return size || interval;
+	}
+
+	size_t size;
+	time_t interval;
+	size_t keep;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class Compressor
+ * @brief Thread compressing closed segments to gzip files,
+ * so writers never wait for compression. Segment is removed when
+ * its compressed file is complete. Segments which are not kept
+ * any more are removed after segment which replaced them
+ * is compressed, so there is never less than policy keeps.
+ */
+class Compressor {
+public:
+	Compressor();
+	~Compressor();
+
+	Compressor(const Compressor&) = delete;
+	const Compressor& operator=(const Compressor&) = delete;
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Compress file to file.gz in background.
+	 * @param obsolete segments to remove after that,
+	 * both plain and compressed.
+	 */
+	void add(const std::string& file,
+			const std::vector<std::string>& obsolete);
+
+	/**
+	 * Wait until all added files are compressed and stop thread.
+	 */
+	void finish();
+
+	/**
+	 * @return errno of first failure or 0.
+	 */
+	int error() const noexcept {
+		return _error;
+	}
+
+	/**
+	 * @return name of file which failed first.
+	 */
+	const std::string& errorFile() const noexcept {
+		return _errorFile;
+	}
+
+	///////////////////////////////////
+
+protected:
+	class Job {
+	public:
+		std::string file;
+		std::vector<std::string> obsolete;
+	};
+
+	void run();
+
+	/**
+	 * @return errno of failure or 0.
+	 */
+	int compress(const std::string& file);
+
+	class Call {
+	public:
+		explicit Call(Compressor* compressor)
+				: _compressor(compressor) {
+		}
+
+		void operator()() {
+			_compressor->run();
+		}
+
+	protected:
+		Compressor* _compressor;
+	};
+
+	///////////////////////////////////
+
+protected:
+	mutex _mutex;
+	condition_variable _added;
+	std::deque<Job> _jobs;
+	bool _finishing;
+	thread* _thread;
+	int _error;
+	std::string _errorFile;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class Rotator
+ * @brief Segments of one output file. Closed file is renamed to
+ * name.0001, name.0002, ... or for HTML file to name.0001.html, ...
+ * and given to compressor. Numbering goes on after segments
+ * which are already there.
+ * Used only from thread writing file.
+ */
+class Rotator {
+public:
+	/**
+	 * @param name name of output file.
+	 * @param policy when file is rotated.
+	 * @param compressor compressor of closed segments, not owned.
+	 */
+	Rotator(const std::string& name, const RotationPolicy& policy,
+			Compressor* compressor);
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * @param size number of bytes which would be written next.
+	 * @return if file should be rotated before they are written.
+	 */
+	bool due(size_t size) const;
+
+	/**
+	 * Count bytes written to file.
+	 */
+	void wrote(size_t size) {
+		_written += size;
+	}
+
+	/**
+	 * Rename file to next segment, create new file under same name
+	 * and give segment to compressor. Writer must be done with file.
+	 * If new file could not be created, segment is renamed back,
+	 * so writer could go on with it.
+	 * @param reopen creates new file, returns errno of failure or 0.
+	 * @return errno of failure or 0.
+	 */
+	int rotate(const std::function<int()>& reopen);
+
+	const std::string& name() const noexcept {
+		return _name;
+	}
+
+	/**
+	 * @return errno of first failed rotation or 0.
+	 */
+	int error() const noexcept {
+		return _error;
+	}
+
+	///////////////////////////////////
+
+protected:
+	std::string segmentName(size_t segment) const;
+
+	/**
+	 * Find numbers of oldest and newest segments in directory.
+	 */
+	void findSegments();
+
+	///////////////////////////////////
+
+protected:
+	std::string _name;
+	RotationPolicy _policy;
+	Compressor* _compressor;
+	/// Name split around segment number.
+	std::string _prefix;
+	std::string _suffix;
+	/// Oldest segment which is not removed, and last one.
+	size_t _oldest;
+	size_t _segment;
+	size_t _written;
+	time_t _start;
+	int _error;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // ROTATION_H_
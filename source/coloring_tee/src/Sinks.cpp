@@ -0,0 +1,334 @@
+/**
+ * @file Sinks.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Outputs to which lines are written.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Sinks.h"
+
+#include <sstream>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+
+using namespace std;
+using namespace ostream_color_log;
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FdSink::flush() {
+	struct iovec* iov = _iov.data();
+	size_t count = _iov.size();
+	while(count && !_error){
+		ssize_t w = writev(_fd, iov, count < IOV_MAX ? count : IOV_MAX);
+		if(w < 0){
+			if(errno == EINTR){
+				continue;
+			}else if(errno == EAGAIN || errno == EWOULDBLOCK){
+				// Non-blocking descriptor, wait until it could take more.
+				struct pollfd fds;
+				fds.fd = _fd;
+				fds.events = POLLOUT;
+				poll(&fds, 1, -1);
+				continue;
+			}
+			_error = errno;
+			break;
+		}
+		// Skip written pieces and cut partially written one.
+		while(count && size_t(w) >= iov->iov_len){
+			w -= iov->iov_len;
+			iov++;
+			count--;
+		}
+		if(count){
+			iov->iov_base = static_cast<char*>(iov->iov_base) + w;
+			iov->iov_len -= w;
+		}
+	}
+	_iov.clear();
+	_batches.clear();
+	_pending = 0;
+}
+
+void FdSink::add(const char* data, size_t size) {
+	struct iovec v;
+	v.iov_base = const_cast<char*>(data);
+	v.iov_len = size;
+	_iov.push_back(v);
+	_pending += size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TerminalSink::TerminalSink(int fd, bool coloring, bool bold,
+		const vector<SearchStringToColor>& rules)
+		: FdSink(fd), _coloring(coloring) {
+	// Escape sequences are rendered by registry.
+	style_registry& registry = style_registry::instance();
+	_plainPrefix = registry.ansi(registry.intern(
+			text_style(text_color(), text_color(),
+					bold ? ostream_color_log::bold : nothing)));
+	for(const SearchStringToColor& rule: rules){
+		_prefixes.push_back(registry.ansi(rule.style));
+	}
+	ostringstream suffixOss;
+	suffixOss << reset << '\n';
+	_suffix = suffixOss.str();
+}
+
+void TerminalSink::write(const LineBatchPtr& batch) {
+	_batches.push_back(batch);
+	if(!_coloring){
+		add(batch->text(), batch->textSize());
+		return;
+	}
+	// Batch from spill file, which workers did not render.
+	_texts.push_back(string());
+	render(*batch, _texts.back());
+	add(_texts.back().data(), _texts.back().size());
+}
+
+void TerminalSink::render(const LineBatch& batch, string& text) const {
+	size_t size = batch.textSize();
+	for(const LineRecord& r: batch.lines){
+		size += (r.found >= 0 ? _prefixes[r.found] : _plainPrefix).size()
+				+ _suffix.size() - 1;
+	}
+	text.reserve(size);
+	for(size_t i = 0; i < batch.lines.size(); i++){
+		const LineRecord& r = batch.lines[i];
+		text += r.found >= 0 ? _prefixes[r.found] : _plainPrefix;
+		text.append(batch.line(i), r.size);
+		text += _suffix;
+	}
+}
+
+void TerminalSink::writeRendered(const LineBatchPtr& batch,
+		const string& text) {
+	_batches.push_back(batch);
+	add(text.data(), text.size());
+}
+
+void TerminalSink::flush() {
+	FdSink::flush();
+	_texts.clear();
+}
+
+HtmlSink::HtmlSink(html_ofstream* file, bool coloring, bool bold,
+		const vector<SearchStringToColor>& rules, Rotator* rotator)
+		: _file(file), _coloring(coloring), _bold(bold), _rules(rules),
+		_baseStyle(white, black, nothing), _pending(0), _rotator(rotator) {
+	if(_coloring){
+		style_registry& registry = style_registry::instance();
+		for(const SearchStringToColor& rule: _rules){
+			_styles.push_back(registry.at(rule.style));
+		}
+		if(_bold){
+			// Lines without color.
+			_plainStyle.add(ostream_color_log::bold);
+		}
+	}
+	declareStyles();
+}
+
+void HtmlSink::declareStyles() {
+	if(!_coloring){
+		return;
+	}
+	for(const text_style& style: _styles){
+		_file->rdbuf()->declare_style(style);
+	}
+	if(_bold){
+		_file->rdbuf()->declare_style(_plainStyle);
+	}
+}
+
+void HtmlSink::write(const LineBatchPtr& batch) {
+	// Rendered same way as on workers, so output does not depend
+	// on where batch was rendered.
+	string text;
+	render(*batch, text);
+	writeRendered(batch, text);
+}
+
+void HtmlSink::render(const LineBatch& batch, string& text) const {
+	stringbuf buffer;
+	html_ofstream s;
+	// Same style as file is opened with, so reset needs no element.
+	s.open(&buffer, white, black, nothing);
+	if(_coloring){
+		for(size_t i = 0; i < batch.lines.size(); i++){
+			const LineRecord& r = batch.lines[i];
+			if(r.found >= 0){
+				s << _styles[r.found];
+			}else if(_bold){
+				s << _plainStyle;
+			}
+			s.write(batch.line(i), r.size);
+			s << reset << '\n';
+		}
+	}else{
+		for(size_t i = 0; i < batch.lines.size(); i++){
+			s.write(batch.line(i), batch.lines[i].size) << '\n';
+		}
+	}
+	// Element of last style stays open, so next batch could go on in it.
+	text = buffer.str();
+}
+
+void HtmlSink::writeRendered(const LineBatchPtr& batch,
+		const string& text) {
+	if(_rotator){
+		if(_rotator->due(text.size())){
+			rotate();
+		}
+		_rotator->wrote(text.size());
+	}
+	if(!batch->lines.empty()){
+		_file->rdbuf()->write_html(text.data(), text.size(),
+				lineStyle(batch->lines.front()), lineStyle(batch->lines.back()));
+	}
+	_pending += text.size();
+	// Counted after text is written, so they go to page which have it.
+	size_t errors = 0;
+	for(const LineRecord& r: batch->lines){
+		errors += r.found >= 0 && _rules[r.found].error;
+	}
+	_file->rdbuf()->count_errors(errors);
+}
+
+void HtmlSink::flush() {
+	_file->flush();
+	_pending = 0;
+}
+
+void HtmlSink::rotate() {
+	const char* name = _rotator->name().c_str();
+	// Segment is complete document.
+	_file->close();
+	int err = _rotator->rotate([&]() {
+		_file->open(name, ios_base::out | ios_base::trunc);
+		return _file->is_open() ? 0 : errno ? errno : EIO;
+	});
+	if(err){
+		// Same document goes on, in place of its footer.
+		_file->open(name, ios_base::out | ios_base::app);
+	}
+	declareStyles();
+	_pending = 0;
+}
+
+const text_style& HtmlSink::lineStyle(const LineRecord& r) const {
+	if(_coloring){
+		if(r.found >= 0){
+			return _styles[r.found];
+		}else if(_bold){
+			return _plainStyle;
+		}
+	}
+	return _baseStyle;
+}
+
+ViewerSink::ViewerSink(html_viewer* viewer, bool coloring, bool bold,
+		const vector<SearchStringToColor>& rules)
+		: _viewer(viewer), _coloring(coloring) {
+	_viewer->declare_style(0, text_style(text_color(), text_color(),
+			bold ? ostream_color_log::bold : nothing));
+	if(_coloring){
+		style_registry& registry = style_registry::instance();
+		for(size_t i = 0; i < rules.size(); i++){
+			_viewer->declare_style(i + 1, registry.at(rules[i].style));
+		}
+	}
+}
+
+void ViewerSink::write(const LineBatchPtr& batch) {
+	string text;
+	render(*batch, text);
+	writeRendered(batch, text);
+}
+
+void ViewerSink::render(const LineBatch& batch, string& text) const {
+	// Escaping makes lines a bit longer.
+	text.reserve(batch.textSize() + batch.lines.size() * 4);
+	for(size_t i = 0; i < batch.lines.size(); i++){
+		html_viewer::render_line(batch.line(i), batch.lines[i].size, text);
+	}
+}
+
+void ViewerSink::writeRendered(const LineBatchPtr& batch,
+		const string& text) {
+	// Every rendered line ends with new line, which escaped
+	// line does not have.
+	const char* line = text.data();
+	for(const LineRecord& r: batch->lines){
+		const char* end = static_cast<const char*>(
+				memchr(line, '\n', text.data() + text.size() - line)) + 1;
+		_viewer->write_line(line, end - line,
+				_coloring && r.found >= 0 ? r.found + 1 : 0);
+		line = end;
+	}
+}
+
+void ViewerSink::flush() {
+	_viewer->flush();
+}
+
+void FileSink::write(const LineBatchPtr& batch) {
+	if(_rotator){
+		if(_rotator->due(batch->textSize())){
+			rotate();
+		}
+		_rotator->wrote(batch->textSize());
+	}
+	_batches.push_back(batch);
+	add(batch->text(), batch->textSize());
+}
+
+void FileSink::rotate() {
+	// Everything buffered goes to segment.
+	flush();
+	if(_error){
+		return;
+	}
+	_rotator->rotate([this]() {
+		int fd = open(_rotator->name().c_str(),
+				O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if(fd < 0){
+			return errno;
+		}
+		// New file takes place of segment at once, so descriptor
+		// always have file to write to.
+		int err = dup2(fd, _fd) < 0 ? errno : 0;
+		close(fd);
+		return err;
+	});
+}
+
+void GzipFileSink::write(const LineBatchPtr& batch) {
+	_file->sputn(batch->text(), batch->textSize());
+	_pending += batch->textSize();
+}
+
+void GzipFileSink::flush() {
+	// Everything written so far could be decompressed.
+	_file->pubsync();
+	_pending = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
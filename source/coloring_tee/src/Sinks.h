@@ -0,0 +1,366 @@
+/**
+ * @file Sinks.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Outputs to which lines are written.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef SINKS_H_
+#define SINKS_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <sys/uio.h>
+
+#include "CommonMacros.h"
+#include "ostream_color_log/html_ofstream.h"
+#include "ostream_color_log/html_viewer.h"
+#include "stl_extensions/gzip_streambuf.h"
+
+#include "LineBatch.h"
+#include "Classifier.h"
+#include "Rotation.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class Sink
+ * @brief Output written by its own pipeline stage.
+ */
+class Sink {
+public:
+	virtual ~Sink() {}
+
+	/**
+	 * Write all lines of batch. They could stay buffered until flush().
+	 * Sink could keep batch until then.
+	 */
+	virtual void write(const LineBatchPtr& batch) = 0;
+
+	/**
+	 * Batches of sinks with non-empty key are rendered with render()
+	 * on worker threads and written with writeRendered().
+	 * Sinks with same key render same text, so batch is rendered
+	 * only once for all of them.
+	 * @return key of rendering, empty if sink does not render.
+	 */
+	virtual std::string renderKey() const {
+		return std::string();
+	}
+
+	/**
+	 * Render batch to text. Called from many threads at once,
+	 * so it must not change sink.
+	 */
+	virtual void render(const LineBatch&, std::string&) const {
+	}
+
+	/**
+	 * Write text which render() made.
+	 * @param batch batch which text is rendered from and kept in.
+	 * @param text text shared with other sinks, valid while batch is.
+	 */
+	virtual void writeRendered(const LineBatchPtr&, const std::string&) {
+	}
+
+	/**
+	 * Write out everything buffered.
+	 */
+	virtual void flush() = 0;
+
+	/**
+	 * @return number of buffered bytes, not written out yet.
+	 */
+	virtual size_t pending() const noexcept = 0;
+
+	/**
+	 * @return errno of write failure or 0.
+	 */
+	virtual int error() const noexcept {
+		return 0;
+	}
+};
+
+///////////////////////////////////////
+
+/**
+ * @class FdSink
+ * @brief Sink writing to file descriptor, with one writev()
+ * for many pieces of batch.
+ * After failure nothing more is written.
+ */
+class FdSink : public Sink {
+public:
+	/**
+	 * @param fd file descriptor, not owned.
+	 */
+	explicit FdSink(int fd)
+			: _fd(fd), _error(0), _pending(0) {
+	}
+
+	void flush() override;
+
+	size_t pending() const noexcept override {
+		return _pending;
+	}
+
+	int error() const noexcept override {
+		return _error;
+	}
+
+protected:
+	/**
+	 * Add piece to be written by flush().
+	 * @param data data which must be valid until flush().
+	 */
+	void add(const char* data, size_t size);
+
+protected:
+	int _fd;
+	int _error;
+	std::vector<struct iovec> _iov;
+	/// Batches which _iov points to.
+	std::vector<LineBatchPtr> _batches;
+	size_t _pending;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class TerminalSink
+ * @brief Lines colored with ANSI escape sequences.
+ */
+class TerminalSink : public FdSink {
+public:
+	/**
+	 * @param fd file descriptor to write to.
+	 * @param coloring if lines are colored at all.
+	 * @param bold if lines are bold.
+	 * @param rules rules which colors lines are taken from.
+	 */
+	TerminalSink(int fd, bool coloring, bool bold,
+			const std::vector<SearchStringToColor>& rules);
+
+	void write(const LineBatchPtr& batch) override;
+
+	std::string renderKey() const override {
+		return _coloring ? "ansi" : "";
+	}
+
+	/**
+	 * Lines with escape sequences are copied to one text,
+	 * which is written with one piece.
+	 */
+	void render(const LineBatch& batch, std::string& text) const override;
+
+	void writeRendered(const LineBatchPtr& batch,
+			const std::string& text) override;
+
+	void flush() override;
+
+protected:
+	bool _coloring;
+	/// Color and bold escape sequences for every rule.
+	std::vector<std::string> _prefixes;
+	/// Bold escape sequence, or nothing, for line without rule.
+	std::string _plainPrefix;
+	/// Reset escape sequence and new line.
+	std::string _suffix;
+	/// Texts rendered by write(), which _iov points to.
+	std::deque<std::string> _texts;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class HtmlSink
+ * @brief Lines colored with HTML styles.
+ */
+class HtmlSink : public Sink {
+public:
+	/**
+	 * @param file opened file, not owned.
+	 * @param coloring if lines are colored at all.
+	 * @param bold if lines are bold.
+	 * @param rules rules which colors lines are taken from.
+	 * Their styles are declared in head of file.
+	 * @param rotator rotator of file or NULL, not owned.
+	 */
+	HtmlSink(ostream_color_log::html_ofstream* file, bool coloring, bool bold,
+			const std::vector<SearchStringToColor>& rules,
+			Rotator* rotator = NULL);
+
+	void write(const LineBatchPtr& batch) override;
+
+	/**
+	 * HTML escaping is slow, so it is done on workers.
+	 */
+	std::string renderKey() const override {
+		return std::string("html") + (_coloring ? "c" : "") + (_bold ? "b" : "");
+	}
+
+	void render(const LineBatch& batch, std::string& text) const override;
+
+	void writeRendered(const LineBatchPtr& batch,
+			const std::string& text) override;
+
+	void flush() override;
+
+	size_t pending() const noexcept override {
+		return _pending;
+	}
+
+protected:
+	/**
+	 * Declare styles of rules in file.
+	 */
+	void declareStyles();
+
+	/**
+	 * Finish file with footer and start new one with header.
+	 */
+	void rotate();
+
+	/**
+	 * @return style which line is rendered with.
+	 */
+	const ostream_color_log::text_style& lineStyle(const LineRecord& r) const;
+
+protected:
+	ostream_color_log::html_ofstream* _file;
+	bool _coloring;
+	bool _bold;
+	const std::vector<SearchStringToColor>& _rules;
+	/// Style of every rule.
+	std::vector<ostream_color_log::text_style> _styles;
+	/// Style of line without rule.
+	ostream_color_log::text_style _plainStyle;
+	/// Style which file and rendering start with.
+	ostream_color_log::text_style _baseStyle;
+	/// Input bytes written to stream since last flush.
+	size_t _pending;
+	Rotator* _rotator;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class ViewerSink
+ * @brief Lines written to chunk files of HTML viewer,
+ * each with id of its style.
+ */
+class ViewerSink : public Sink {
+public:
+	/**
+	 * @param viewer opened viewer, not owned.
+	 * @param coloring if lines are colored at all.
+	 * @param bold if lines are bold.
+	 * @param rules rules which colors lines are taken from.
+	 * Style of rule k have id k + 1 in viewer.
+	 */
+	ViewerSink(ostream_color_log::html_viewer* viewer, bool coloring,
+			bool bold, const std::vector<SearchStringToColor>& rules);
+
+	void write(const LineBatchPtr& batch) override;
+
+	std::string renderKey() const override {
+		return "viewer";
+	}
+
+	void render(const LineBatch& batch, std::string& text) const override;
+
+	void writeRendered(const LineBatchPtr& batch,
+			const std::string& text) override;
+
+	void flush() override;
+
+	size_t pending() const noexcept override {
+		return _viewer->pending();
+	}
+
+	int error() const noexcept override {
+		return _viewer->error();
+	}
+
+protected:
+	ostream_color_log::html_viewer* _viewer;
+	bool _coloring;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class FileSink
+ * @brief Lines without any coloring, like tee writes them.
+ */
+class FileSink : public FdSink {
+public:
+	/**
+	 * @param fd opened file, not owned.
+	 * @param rotator rotator of file or NULL, not owned.
+	 */
+	explicit FileSink(int fd, Rotator* rotator = NULL)
+			: FdSink(fd), _rotator(rotator) {
+	}
+
+	void write(const LineBatchPtr& batch) override;
+
+protected:
+	/**
+	 * Write out buffered lines to file and put new file
+	 * under same descriptor.
+	 */
+	void rotate();
+
+protected:
+	Rotator* _rotator;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class GzipFileSink
+ * @brief Lines without coloring, compressed to gzip file.
+ * Sink only copies lines to buffer, and file compresses them
+ * on its own thread.
+ */
+class GzipFileSink : public Sink {
+public:
+	/**
+	 * @param file opened file, not owned.
+	 */
+	explicit GzipFileSink(stl_extensions::gzip_streambuf* file)
+			: _file(file), _pending(0) {
+	}
+
+	void write(const LineBatchPtr& batch) override;
+
+	void flush() override;
+
+	size_t pending() const noexcept override {
+		return _pending;
+	}
+
+	int error() const noexcept override {
+		return _file->error();
+	}
+
+protected:
+	stl_extensions::gzip_streambuf* _file;
+	size_t _pending;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // SINKS_H_
@@ -0,0 +1,151 @@
+/**
+ * @file SpillFile.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Temporary file holding batches which do not fit in sink queue.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SpillFile.h"
+
+#include <string>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "config.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SpillHeader {
+public:
+	size_t lineCount;
+	size_t dataSize;
+	size_t sequence;
+};
+
+static int writeAll(int fd, const void* buffer, size_t size, off_t offset) {
+	const char* p = static_cast<const char*>(buffer);
+	while(size){
+		ssize_t w = pwrite(fd, p, size, offset);
+		if(w < 0){
+			if(errno == EINTR){
+				continue;
+			}
+			return errno;
+		}
+		p += w;
+		size -= w;
+		offset += w;
+	}
+	return 0;
+}
+
+static int readAll(int fd, void* buffer, size_t size, off_t offset) {
+	char* p = static_cast<char*>(buffer);
+	while(size){
+		ssize_t r = pread(fd, p, size, offset);
+		if(r < 0){
+			if(errno == EINTR){
+				continue;
+			}
+			return errno;
+		}else if(r == 0){
+			return EIO;
+		}
+		p += r;
+		size -= r;
+		offset += r;
+	}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SpillFile::SpillFile()
+		: _fd(-1), _writeOffset(0), _readOffset(0) {
+}
+
+SpillFile::~SpillFile() {
+	if(_fd >= 0){
+		close(_fd);
+	}
+}
+
+int SpillFile::open() {
+	const char* dir = getenv("TMPDIR");
+	std::string name = std::string(dir && *dir ? dir : "/tmp")
+			+ "/" PROGRAM_NAME "-spill-XXXXXX";
+	_fd = mkstemp(&name[0]);
+	if(_fd < 0){
+		return errno;
+	}
+	// Nobody else needs it and it is gone even if program crashes.
+	unlink(name.c_str());
+	return 0;
+}
+
+int SpillFile::write(const LineBatch& batch) {
+	SpillHeader header;
+	header.lineCount = batch.lines.size();
+	header.dataSize = batch.textSize();
+	header.sequence = batch.sequence;
+	off_t offset = _writeOffset;
+	int err = writeAll(_fd, &header, sizeof(header), offset);
+	offset += sizeof(header);
+	if(!err){
+		err = writeAll(_fd, batch.lines.data(),
+				header.lineCount*sizeof(LineRecord), offset);
+		offset += header.lineCount*sizeof(LineRecord);
+	}
+	if(!err){
+		err = writeAll(_fd, batch.text(), header.dataSize, offset);
+		offset += header.dataSize;
+	}
+	if(!err){
+		// Batch which failed to be written is overwritten by next one.
+		_writeOffset = offset;
+	}
+	return err;
+}
+
+LineBatchPtr SpillFile::read() {
+	SpillHeader header;
+	off_t offset = _readOffset;
+	if(readAll(_fd, &header, sizeof(header), offset)){
+		return LineBatchPtr();
+	}
+	offset += sizeof(header);
+	LineBatchPtr batch = std::make_shared<LineBatch>();
+	InputBlockPtr block = std::make_shared<InputBlock>(header.dataSize);
+	batch->lines.resize(header.lineCount);
+	batch->setText(block, block->data(), header.dataSize);
+	batch->sequence = header.sequence;
+	if(readAll(_fd, batch->lines.data(), header.lineCount*sizeof(LineRecord),
+			offset)){
+		return LineBatchPtr();
+	}
+	offset += header.lineCount*sizeof(LineRecord);
+	if(readAll(_fd, block->data(), header.dataSize, offset)){
+		return LineBatchPtr();
+	}
+	offset += header.dataSize;
+
+	// Free disk space of read batch, file keeps its size.
+	fallocate(_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+			_readOffset, offset - _readOffset);
+	_readOffset = offset;
+	return batch;
+}
+
+///////////////////////////////////////////////////////////////////////////////
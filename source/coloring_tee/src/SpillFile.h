@@ -0,0 +1,74 @@
+/**
+ * @file SpillFile.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Temporary file holding batches which do not fit in sink queue.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef SPILLFILE_H_
+#define SPILLFILE_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <sys/types.h>
+
+#include "CommonMacros.h"
+
+#include "LineBatch.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class SpillFile
+ * @brief Unlinked temporary file used as queue of batches.
+ * One thread writes batches to end of it and other one reads them from
+ * begin. Reader must not read batch before writer tells it, over sink
+ * queue, that batch is written. Read part of file is given back
+ * to file system, so file takes only space of unread batches.
+ */
+class SpillFile {
+public:
+	SpillFile();
+	~SpillFile();
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Create file in $TMPDIR or /tmp.
+	 * @return errno of failure or 0.
+	 */
+	int open();
+
+	/**
+	 * Append batch.
+	 * @return errno of failure or 0.
+	 */
+	int write(const LineBatch& batch);
+
+	/**
+	 * Read oldest batch not read yet.
+	 * @return read batch or null on failure.
+	 */
+	LineBatchPtr read();
+
+	///////////////////////////////////
+
+protected:
+	int _fd;
+	off_t _writeOffset;
+	off_t _readOffset;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // SPILLFILE_H_
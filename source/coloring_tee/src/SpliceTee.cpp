@@ -0,0 +1,230 @@
+/**
+ * @file SpliceTee.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Copying input pipe to files inside kernel, with tee(2)
+ * and splice(2).
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SpliceTee.h"
+
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define WANTED_PIPE_SIZE (1 << 20)
+
+///////////////////////////////////////////////////////////////////////////////
+
+SpliceTee::SpliceTee(int in)
+		: _in(in), _interruptFd(-1) {
+	// Bigger pipe means less system calls per byte.
+	fcntl(_in, F_SETPIPE_SZ, WANTED_PIPE_SIZE);
+	int size = fcntl(_in, F_GETPIPE_SZ);
+	_pipeSize = size > 0 ? size : 1 << 16;
+}
+
+SpliceTee::~SpliceTee() {
+	for(Output& o: _outputs){
+		close(o.pipe[0]);
+		close(o.pipe[1]);
+	}
+}
+
+bool SpliceTee::canTee(int fd) {
+	struct stat s;
+	return !fstat(fd, &s) && S_ISFIFO(s.st_mode);
+}
+
+bool SpliceTee::addOutput(int fd, const std::string& name) {
+	struct stat s;
+	if(fstat(fd, &s) || !(S_ISFIFO(s.st_mode) || S_ISREG(s.st_mode))){
+		return false;
+	}
+	int flags = fcntl(fd, F_GETFL);
+	if(flags < 0 || (flags & O_APPEND)){
+		// splice(2) refuses files opened for appending.
+		return false;
+	}
+
+	Output o;
+	o.fd = fd;
+	o.name = name;
+	o.copied = 0;
+	o.error = 0;
+	if(pipe(o.pipe)){
+		return false;
+	}
+	// Same size as input, so every tee could take whole input.
+	fcntl(o.pipe[1], F_SETPIPE_SZ, _pipeSize);
+	_outputs.push_back(o);
+	return true;
+}
+
+bool SpliceTee::empty() const noexcept {
+	for(const Output& o: _outputs){
+		if(!o.error){
+			return false;
+		}
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ssize_t SpliceTee::duplicate(size_t size) {
+	if(!waitInput()){
+		return 0;
+	}
+	return teeOutputs(size, _outputs.size());
+}
+
+int SpliceTee::passthrough() {
+	// Last output takes input with splice, others get copy with tee.
+	Output& last = _outputs.back();
+	while(waitInput()){
+		bool teeing = false;
+		for(size_t i = 0; i + 1 < _outputs.size(); i++){
+			teeing |= !_outputs[i].error;
+		}
+
+		if(teeing){
+			ssize_t n = teeOutputs(_pipeSize, _outputs.size() - 1);
+			if(n < 0){
+				return errno;
+			}else if(n == 0){
+				break;
+			}
+			if(!moveAll(_in, last, n)){
+				return EIO;
+			}
+			continue;
+		}
+
+		// Nobody to keep in step with, take what is there.
+		ssize_t s;
+		if(last.error){
+			char buffer[4096];
+			s = read(_in, buffer, sizeof(buffer));
+		}else{
+			s = splice(_in, NULL, last.fd, NULL, _pipeSize, SPLICE_F_MOVE);
+		}
+		if(s == 0){
+			break;
+		}else if(s < 0 && errno != EINTR){
+			if(last.error){
+				return errno;
+			}
+			// Could be output or input failure, try again with read.
+			last.error = errno;
+		}
+	}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SpliceTee::waitInput() {
+	if(_interruptFd < 0){
+		return true;
+	}
+	struct pollfd fds[2];
+	fds[0].fd = _in;
+	fds[0].events = POLLIN;
+	fds[1].fd = _interruptFd;
+	fds[1].events = POLLIN;
+	while(poll(fds, 2, -1) < 0){
+		if(errno != EINTR){
+			return true;
+		}
+	}
+	return !fds[1].revents;
+}
+
+ssize_t SpliceTee::teeOutputs(size_t size, size_t count) {
+	if(size > _pipeSize){
+		size = _pipeSize;
+	}
+	// Tee could copy less to some output, so all move only what
+	// all of them got and throw away rest.
+	ssize_t n = size;
+	bool any = false;
+	for(size_t i = 0; i < count; i++){
+		Output& o = _outputs[i];
+		o.copied = 0;
+		if(o.error){
+			continue;
+		}
+		ssize_t t;
+		do{
+			t = tee(_in, o.pipe[1], any ? n : size, 0);
+		}while(t < 0 && errno == EINTR);
+		if(t < 0){
+			return -1;
+		}
+		o.copied = t;
+		n = t < n ? t : n;
+		any = true;
+	}
+	if(!any){
+		return size;
+	}
+	for(size_t i = 0; i < count; i++){
+		if(!_outputs[i].error){
+			drainOutput(_outputs[i], n);
+		}
+	}
+	return n;
+}
+
+void SpliceTee::drainOutput(Output& o, size_t size) {
+	moveAll(o.pipe[0], o, size);
+	if(o.copied > size){
+		discard(o.pipe[0], o.copied - size);
+	}
+	o.copied = 0;
+}
+
+bool SpliceTee::moveAll(int from, Output& o, size_t size) {
+	while(size && !o.error){
+		ssize_t s = splice(from, NULL, o.fd, NULL, size, SPLICE_F_MOVE);
+		if(s > 0){
+			size -= s;
+		}else if(s == 0){
+			return size == 0;
+		}else if(errno != EINTR){
+			o.error = errno;
+		}
+	}
+	discard(from, size);
+	return true;
+}
+
+void SpliceTee::discard(int fd, size_t size) {
+	char buffer[4096];
+	while(size){
+		ssize_t r = read(fd, buffer, size < sizeof(buffer)
+				? size : sizeof(buffer));
+		if(r > 0){
+			size -= r;
+		}else if(r == 0 || errno != EINTR){
+			break;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,170 @@
+/**
+ * @file SpliceTee.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Copying input pipe to files inside kernel, with tee(2)
+ * and splice(2).
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef SPLICETEE_H_
+#define SPLICETEE_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "CommonMacros.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class SpliceTee
+ * @brief Outputs which get input bytes as they are, without going
+ * through user space.
+ * Data waiting in input pipe is copied with tee(2) to pipe of every
+ * output, without consuming it, and moved from there to output with
+ * splice(2). Then caller consumes same amount of input, by reading it
+ * or by passthrough().
+ */
+class SpliceTee {
+public:
+	/**
+	 * @param in input file descriptor, must be pipe.
+	 */
+	explicit SpliceTee(int in = 0);
+	~SpliceTee();
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * @return true if fd is pipe which could be input.
+	 */
+	static bool canTee(int fd);
+
+	/**
+	 * Add output, if it could be written with splice(2).
+	 * It could be pipe or regular file not opened for appending.
+	 * @param fd output file descriptor, not owned.
+	 * @param name name of output for messages.
+	 * @return false if fd could not be used, then it must be written
+	 * other way.
+	 */
+	bool addOutput(int fd, const std::string& name);
+
+	/**
+	 * Stop waiting for input when fd become readable.
+	 * @param fd file descriptor to watch, -1 to not watch any.
+	 */
+	void setInterruptFd(int fd) noexcept {
+		_interruptFd = fd;
+	}
+
+	/**
+	 * @return true if there is no output which works.
+	 */
+	bool empty() const noexcept;
+
+	/**
+	 * Copy bytes waiting in input to all outputs, without consuming them.
+	 * Waits for input if there is none.
+	 * @param size maximal number of bytes to copy.
+	 * @return number of copied bytes which caller must consume from
+	 * input before calling again, 0 on end of input or interrupt,
+	 * -1 on error with errno set.
+	 */
+	ssize_t duplicate(size_t size);
+
+	/**
+	 * Copy all input to outputs until end of input,
+	 * when nothing else needs input.
+	 * @return errno of input failure or 0.
+	 */
+	int passthrough();
+
+	///////////////////////////////////
+
+public:
+	size_t outputCount() const noexcept {
+		return _outputs.size();
+	}
+
+	const std::string& outputName(size_t output) const noexcept {
+		return _outputs[output].name;
+	}
+
+	/**
+	 * @return errno of failure of output or 0.
+	 */
+	int outputError(size_t output) const noexcept {
+		return _outputs[output].error;
+	}
+
+	///////////////////////////////////
+
+protected:
+	class Output {
+	public:
+		int fd;
+		std::string name;
+		/// Pipe holding copy of input until it is moved to fd.
+		int pipe[2];
+		/// Bytes copied to pipe by last tee.
+		size_t copied;
+		int error;
+	};
+
+	/**
+	 * Wait for input or interrupt.
+	 * @return false on interrupt.
+	 */
+	bool waitInput();
+
+	/**
+	 * Tee input to first count outputs.
+	 * @return bytes copied to all of them, 0 on end of input,
+	 * -1 on error.
+	 */
+	ssize_t teeOutputs(size_t size, size_t count);
+
+	/**
+	 * Move size bytes from output pipe to output, throwing away
+	 * anything more in pipe.
+	 */
+	void drainOutput(Output& o, size_t size);
+
+	/**
+	 * Move size bytes from fd to output, or just throw them away
+	 * if output failed.
+	 * @return false if fd failed.
+	 */
+	bool moveAll(int from, Output& o, size_t size);
+
+	/**
+	 * Read and throw away size bytes from fd.
+	 */
+	void discard(int fd, size_t size);
+
+	///////////////////////////////////
+
+protected:
+	int _in;
+	int _interruptFd;
+	size_t _pipeSize;
+	std::vector<Output> _outputs;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // SPLICETEE_H_
@@ -19,18 +19,31 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <algorithm>
 #include <csignal>
 #include <cstdlib>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <cerrno>
+#include <cstring>
+#include <climits>
+#include <iomanip>
 using namespace std;
 
 #include "ostream_color_log/ostream_coloring.h"
 #include "ostream_color_log/html_ofstream.h"
+#include "ostream_color_log/html_viewer.h"
+#include "stl_extensions/gzip_streambuf.h"
 using namespace ostream_color_log;
 
 #include "LuaConfig.h"
+#include "LineReader.h"
+#include "Classifier.h"
+#include "Sinks.h"
+#include "Pipeline.h"
+#include "SpliceTee.h"
+#include "Rotation.h"
 
 #include "options.h"
 
@@ -48,59 +61,37 @@ static const char* versionString =
 "\n"
 "Written by Milos Subotic.";
 
-static vector<ofstream*> files;
+static vector<int> files;
+static vector<stl_extensions::gzip_streambuf*> gzipFiles;
 static vector<html_ofstream*> htmlFiles;
+static vector<html_viewer*> htmlViewers;
+static Compressor* compressor = 0;
 
-///////////////////////////////////////////////////////////////////////////////
-
-class String2OstreamColors{
-private:
-	map<string, ostream_colors> lookupTable;
-public:
-	String2OstreamColors(){
-		lookupTable["black"] = black;
-		lookupTable["red"] = red;
-		lookupTable["green"] = green;
-		lookupTable["yellow"] = yellow;
-		lookupTable["blue"] = blue;
-		lookupTable["magenta"] = magenta;
-		lookupTable["cyan"] = cyan;
-		lookupTable["white"] = white;
-	}
-
-	ostream_colors operator[](const string& s){
-		return lookupTable[s];
-	}
-};
-
-class SearchStringToColor{
-public:
-	std::string searchString;
-	ostream_colors color;
-
-	static String2OstreamColors _table;
-
-public:
-	SearchStringToColor(const std::string& searchString_,
-			const std::string& color_)
-			: searchString(searchString_), color(_table[color_]){
-	}
-};
-
-String2OstreamColors SearchStringToColor::_table;
+// Signal handler wakes reader by writing to this pipe.
+static int interruptPipe[2] = { -1, -1 };
+static volatile sig_atomic_t interruptSignal = 0;
 
 ///////////////////////////////////////////////////////////////////////////////
 
 static void cleanUp(int returnCode) __attribute__((noreturn));
 static void cleanUp(int returnCode){
 	for(int i = 0; i < files.size(); i++){
-		files[i]->close();
-		delete files[i];
+		close(files[i]);
+	}
+	for(size_t i = 0; i < gzipFiles.size(); i++){
+		gzipFiles[i]->close();
+		delete gzipFiles[i];
 	}
 	for(int i = 0; i < htmlFiles.size(); i++){
 		htmlFiles[i]->close();
 		delete htmlFiles[i];
 	}
+	for(int i = 0; i < htmlViewers.size(); i++){
+		htmlViewers[i]->close();
+		delete htmlViewers[i];
+	}
+	// Closed segments are compressed before exit.
+	delete compressor;
 	cout << flush;
 
 	// Terminate program.
@@ -108,12 +99,137 @@ static void cleanUp(int returnCode){
 }
 
 static void signalCallbackHandler(int signum){
+	if(interruptPipe[1] >= 0){
+		if(!interruptSignal){
+			// Stop reading, but write out everything already read.
+			interruptSignal = signum;
+			char c = 0;
+			ssize_t r = write(interruptPipe[1], &c, 1);
+			(void)r;
+			return;
+		}
+		// Second interrupt, do not wait for slow outputs.
+		_exit(signum);
+	}
 	// Cleanup and close up stuff here.
 	cleanUp(signum);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * @return if file is compressed while it is written.
+ */
+static bool isCompressed(const string& fileName){
+	return fileName.size() > 3
+			&& fileName.compare(fileName.size() - 3, 3, ".gz") == 0;
+}
+
+/**
+ * Print how much file is compressed and how fast.
+ */
+static void printCompression(const string& fileName,
+		const stl_extensions::gzip_streambuf& file){
+	double in = file.bytes_in();
+	double out = file.bytes_out();
+	double mb = 1 << 20;
+	cerr << PROGRAM_NAME << ": " << fileName << ": compressed " << fixed
+			<< setprecision(1) << in / mb << " MB to " << out / mb
+			<< " MB, ratio " << (out ? in / out : 0) << ", "
+			<< (file.seconds() > 0 ? in / mb / file.seconds() : 0)
+			<< " MB/s" << endl;
+}
+
+/**
+ * Read number from 0 to max from argument of option.
+ * @param what name of number for error message.
+ */
+static long readNumber(const option::Option& opt, long max, const char* what){
+	string arg = opt.arg;
+	if(!arg.empty() && arg[0] == '='){
+		arg.erase(0, 1);
+	}
+	char* end;
+	long number = strtol(arg.c_str(), &end, 10);
+	if(arg.empty() || *end || number < 0 || number > max){
+		cerr << PROGRAM_NAME << ": Invalid " << what << " \""
+				<< arg << "\"!" << endl;
+		cleanUp(-1);
+	}
+	return number;
+}
+
+/**
+ * Read color and background of rule and give style of rule its id.
+ * Also read if lines of rule are errors.
+ */
+static void readRuleStyle(LuaConfig& config, SearchStringToColor& rule,
+		bool bold){
+	const char* fields[] = { "color", "background" };
+	text_color* colors[] = { &rule.color, &rule.background };
+	for(int i = 0; i < 2; i++){
+		if(i > 0 && !config.haveField(fields[i])){
+			continue;
+		}
+		string name = config.getFieldString(fields[i]);
+		if(!text_color::parse(name, *colors[i])){
+			cerr << PROGRAM_NAME << ": Unknown color \"" << name
+					<< "\" for \"" << rule.searchString << "\"!" << endl;
+			cleanUp(-1);
+		}
+	}
+	if(config.haveField("error")){
+		rule.error = config.getFieldBool("error");
+	}
+	ostream_attributes attribute = bold ? ostream_color_log::bold : nothing;
+	rule.style = style_registry::instance().intern(
+			text_style(rule.color, rule.background, attribute));
+}
+
+/**
+ * Read where search string must be in line, from anchor, column
+ * or field of rule on top of Lua stack.
+ */
+static void readRulePosition(LuaConfig& config, SearchStringToColor& rule){
+	if(config.haveField("anchor")){
+		string anchor = config.getFieldString("anchor");
+		if(anchor == "start"){
+			rule.position = PositionalMatcher::START;
+		}else if(anchor == "end"){
+			rule.position = PositionalMatcher::END;
+		}else{
+			cerr << PROGRAM_NAME << ": Unknown anchor \"" << anchor
+					<< "\" for \"" << rule.searchString << "\"!" << endl;
+			cleanUp(-1);
+		}
+	}else if(config.haveField("column")){
+		rule.position = PositionalMatcher::COLUMN;
+		rule.index = config.getFieldInt("column");
+		if(rule.index < 1){
+			cerr << PROGRAM_NAME << ": Column for \"" << rule.searchString
+					<< "\" must be 1 or more!" << endl;
+			cleanUp(-1);
+		}
+	}else if(config.haveField("field")){
+		rule.position = PositionalMatcher::FIELD;
+		rule.index = config.getFieldInt("field");
+		if(rule.index < 1 || rule.index > PositionalMatcher::MAX_FIELD){
+			cerr << PROGRAM_NAME << ": Field for \"" << rule.searchString
+					<< "\" must be from 1 to " << PositionalMatcher::MAX_FIELD
+					<< "!" << endl;
+			cleanUp(-1);
+		}
+	}
+	if(rule.isPattern && rule.position >= 0){
+		cerr << PROGRAM_NAME << ": Anchor, column and field are not used "
+				<< "with pattern \"" << rule.searchString
+				<< "\", use ^ and $ instead!" << endl;
+		cleanUp(-1);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 static void checkUserConfigDir(const string& userConfigDirName){
 	// rwxr-xr-x.
 	mode_t mode = S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH;
@@ -255,7 +371,120 @@ int main(int argc, char** argv){
 	config.open(configFileName.c_str());
 
 
+	// Input file is put in place of standard input.
+	string inputName = "standard input";
+	if(options[INPUT].arg){
+		string arg = options[INPUT].arg;
+		if(!arg.empty() && arg[0] == '='){
+			arg.erase(0, 1);
+		}
+		int fd = open(arg.c_str(), O_RDONLY);
+		if(fd < 0 || dup2(fd, STDIN_FILENO) < 0){
+			cerr << PROGRAM_NAME << ": Cannot open input file \""
+					<< arg << "\": " << strerror(errno) << endl;
+			cleanUp(-1);
+		}
+		close(fd);
+		inputName = arg;
+	}
+
 	bool append = options[APPEND];
+	vector<string> htmlFileNames;
+	vector<string> fileNames;
+	vector<string> gzipFileNames;
+
+	// Queue policy for every sink, by file name.
+	Pipeline::QueuePolicy defaultQueuePolicy = Pipeline::BLOCK;
+	map<string, Pipeline::QueuePolicy> queuePolicies;
+	for(option::Option* opt = &options[QUEUE_POLICY]; opt; opt = opt->next()){
+		if(!opt->arg){
+			continue;
+		}
+		string arg = opt->arg;
+		// Remove = on begin of option string.
+		if(!arg.empty() && arg[0] == '='){
+			arg.erase(0, 1);
+		}
+		// File name could have =, but policy could not.
+		size_t equal = arg.rfind('=');
+		string policyName = equal == string::npos
+				? arg : arg.substr(equal + 1);
+		Pipeline::QueuePolicy policy;
+		if(policyName == "block"){
+			policy = Pipeline::BLOCK;
+		}else if(policyName == "drop-oldest"){
+			policy = Pipeline::DROP_OLDEST;
+		}else if(policyName == "spill-to-disk"){
+			policy = Pipeline::SPILL_TO_DISK;
+		}else{
+			cerr << PROGRAM_NAME << ": Unknown queue policy \""
+					<< policyName << "\"!" << endl;
+			cleanUp(-1);
+		}
+		if(equal == string::npos){
+			defaultQueuePolicy = policy;
+		}else{
+			queuePolicies[arg.substr(0, equal)] = policy;
+		}
+	}
+
+	// Terminals are written at once, but when input is flooding
+	// everything is written in big pieces.
+	int flushIdleMs = 100;
+	if(options[FLUSH_IDLE].arg){
+		string arg = options[FLUSH_IDLE].arg;
+		if(!arg.empty() && arg[0] == '='){
+			arg.erase(0, 1);
+		}
+		char* end;
+		long ms = strtol(arg.c_str(), &end, 10);
+		if(arg.empty() || *end || ms < 0 || ms > 1000000){
+			cerr << PROGRAM_NAME << ": Invalid flush idle time \""
+					<< arg << "\"!" << endl;
+			cleanUp(-1);
+		}
+		flushIdleMs = ms;
+	}
+
+	// Big HTML files are split to pages.
+	size_t htmlPageLines = 0;
+	size_t htmlPageBytes = 0;
+	if(options[HTML_PAGE_LINES].arg){
+		htmlPageLines = readNumber(options[HTML_PAGE_LINES], LONG_MAX,
+				"number of lines per page");
+	}
+	if(options[HTML_PAGE_SIZE].arg){
+		htmlPageBytes = readNumber(options[HTML_PAGE_SIZE], 1 << 20,
+				"page size") << 20;
+	}
+
+	// Outputs are closed as segments and new ones are started.
+	RotationPolicy rotation;
+	if(options[ROTATE_SIZE].arg){
+		rotation.size = readNumber(options[ROTATE_SIZE], 1 << 20,
+				"rotation size") << 20;
+	}
+	if(options[ROTATE_INTERVAL].arg){
+		rotation.interval = readNumber(options[ROTATE_INTERVAL], LONG_MAX,
+				"rotation interval");
+	}
+	if(options[KEEP].arg){
+		rotation.keep = readNumber(options[KEEP], LONG_MAX,
+				"number of kept files");
+		if(!rotation.enabled()){
+			cerr << PROGRAM_NAME << ": --keep is used only with"
+					" --rotate-size or --rotate-interval!" << endl;
+			cleanUp(-1);
+		}
+	}
+	if(rotation.enabled()){
+		if(htmlPageLines || htmlPageBytes){
+			cerr << PROGRAM_NAME << ": HTML files split to pages"
+					" cannot be rotated!" << endl;
+			cleanUp(-1);
+		}
+		compressor = new Compressor();
+	}
 
 	for(option::Option* opt = &options[HTML_OUTPUT]; opt; opt = opt->next()){
 		if(!opt->arg){
@@ -267,12 +496,23 @@ int main(int argc, char** argv){
 			continue;
 		}
 
-		html_ofstream* htmlFile;
+		if((htmlPageLines || htmlPageBytes) && isCompressed(fileName)){
+			cerr << PROGRAM_NAME << ": " << fileName << ": Compressed HTML"
+					" file cannot be split to pages" << endl;
+			continue;
+		}
+		if(rotation.enabled() && isCompressed(fileName)){
+			cerr << PROGRAM_NAME << ": " << fileName << ": Compressed HTML"
+					" file cannot be rotated" << endl;
+			continue;
+		}
+
+		html_ofstream* htmlFile = new html_ofstream();
+		htmlFile->rdbuf()->set_paging(htmlPageLines, htmlPageBytes);
 		if(append){
-			htmlFile = new html_ofstream(fileName.c_str(),
-					ios_base::out | ios_base::app);
+			htmlFile->open(fileName.c_str(), ios_base::out | ios_base::app);
 		}else{
-			htmlFile = new html_ofstream(fileName.c_str(), ios_base::out);
+			htmlFile->open(fileName.c_str(), ios_base::out);
 		}
 
 		if(!htmlFile->is_open()){
@@ -283,7 +523,28 @@ int main(int argc, char** argv){
 		}
 
 		htmlFiles.push_back(htmlFile);
+		htmlFileNames.push_back(fileName);
+
+	}
+
+	vector<string> htmlViewerNames;
+	for(option::Option* opt = &options[HTML_VIEWER]; opt; opt = opt->next()){
+		if(!opt->arg){
+			continue;
+		}
+		string fileName = opt->arg;
+
+		html_viewer* viewer = new html_viewer();
+		int err = viewer->open(fileName);
+		if(err){
+			cerr << PROGRAM_NAME << ": " << fileName << ": " << strerror(err)
+					<< endl;
+			delete viewer;
+			continue;
+		}
 
+		htmlViewers.push_back(viewer);
+		htmlViewerNames.push_back(fileName);
 	}
 
 	for(int i = 0; i < parse.nonOptionsCount(); i++){
@@ -293,31 +554,51 @@ int main(int argc, char** argv){
 			continue;
 		}
 
-		ofstream* file;
-		if(append){
-			file = new ofstream(fileName.c_str(),
-					ios_base::out | ios_base::app);
-		}else{
-			file = new ofstream(fileName.c_str(), ios_base::out);
+		if(isCompressed(fileName)){
+			if(rotation.enabled()){
+				cerr << PROGRAM_NAME << ": " << fileName << ": Compressed"
+						" file cannot be rotated" << endl;
+				continue;
+			}
+			stl_extensions::gzip_streambuf* gzipFile =
+					new stl_extensions::gzip_streambuf();
+			if(!gzipFile->open(fileName.c_str(),
+					append ? ios_base::out | ios_base::app : ios_base::out)){
+				cerr << PROGRAM_NAME << ": " << fileName << ": "
+						<< strerror(errno) << endl;
+				delete gzipFile;
+				continue;
+			}
+			gzipFiles.push_back(gzipFile);
+			gzipFileNames.push_back(fileName);
+			continue;
 		}
 
-		if(!file->is_open()){
-			cerr << PROGRAM_NAME << ": " << fileName << ": Permission denied"
-					<< endl;
-			delete file;
+		// Sinks write to plain files with writev(), not through streams.
+		int file = open(fileName.c_str(),
+				O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0666);
+
+		if(file < 0){
+			cerr << PROGRAM_NAME << ": " << fileName << ": "
+					<< strerror(errno) << endl;
 			continue;
 		}
 
 		files.push_back(file);
+		fileNames.push_back(fileName);
 	}
 
 	bool coloringBold = !options[NO_BOLD];
 	bool coloringEnabled = !options[NO_COLORS];
 
 	vector<SearchStringToColor> searchStringToColor;
+	size_t dfaCacheSize = 2 << 20;
 
 	if(coloringEnabled){
 		config.getGlobalTable("coloring_tee_config");
+		if(config.haveField("dfa_cache_size")){
+			dfaCacheSize = config.getFieldInt("dfa_cache_size");
+		}
 		config.getFieldTable("color_schemes");
 
 		// Get enabled color schemes from option flags.
@@ -337,6 +618,8 @@ int main(int argc, char** argv){
 			}
 		}
 
+		// Rules with their scheme and rule names.
+		vector<pair<string, SearchStringToColor>> rules;
 		for(config.iterationInit(); config.iterationCondition();
 				config.iterationIncrement()){
 			string colorScheme = config.getKeyAsString();
@@ -344,71 +627,251 @@ int main(int argc, char** argv){
 			if(colorSchemes.find(colorScheme) != colorSchemes.end()){
 				for(lua_pushnil(config.L); lua_next(config.L, -2);
 						lua_pop(config.L, 1)){
-					searchStringToColor.push_back(
-							SearchStringToColor(
-									config.getFieldString("searchString"),
-											config.getFieldString("color")));
+					string name = colorScheme + "." + config.getKeyAsString();
+					bool isPattern = config.haveField("pattern");
+					SearchStringToColor rule(
+							config.getFieldString(
+									isPattern ? "pattern" : "searchString"),
+							isPattern);
+					readRuleStyle(config, rule, coloringBold);
+					readRulePosition(config, rule);
+					if(config.haveField("priority")){
+						rule.priority = config.getFieldInt("priority");
+					}
+					rules.push_back(make_pair(name, rule));
 				}
 			}
 		}
+		// Lua visits table in order of its hash, so rules are sorted
+		// to have same priorities on every run.
+		sort(rules.begin(), rules.end(),
+				[](const pair<string, SearchStringToColor>& a,
+						const pair<string, SearchStringToColor>& b) {
+					if(a.second.priority != b.second.priority){
+						return a.second.priority > b.second.priority;
+					}
+					return a.first < b.first;
+				});
+		for(const pair<string, SearchStringToColor>& rule: rules){
+			searchStringToColor.push_back(rule.second);
+		}
 
 		config.pop();
 		config.pop();
 	}
 
-	// Just for debugging.
-	//ifstream cin("test/four_lines.txt");
+	Classifier classifier(dfaCacheSize);
+	try{
+		classifier.compile(searchStringToColor);
+	}catch(const Exception& e){
+		cerr << PROGRAM_NAME << ": " << e.what();
+		cleanUp(-1);
+	}
 
-	if(coloringEnabled){
-		string line;
-		while(getline(cin, line)){
-
-			for(int i = 0; i < searchStringToColor.size(); i++){
-				size_t found = line.find(
-						searchStringToColor[i].searchString);
-				if(found != string::npos){
-					ostream_colors color = searchStringToColor[i].color;
-					cout << color;
-					for(int i = 0; i < htmlFiles.size(); i++){
-						*htmlFiles[i] << color;
-					}
-					break;
-				}
-			}
-			if(coloringBold){
-				cout << bold;
-				for(int i = 0; i < htmlFiles.size(); i++){
-					*htmlFiles[i] << bold;
-				}
-			}
+	LineReader reader(STDIN_FILENO);
+	// Regular file is mapped, so lines are not copied from it.
+	reader.map();
+	// Files are split to batches colored in parallel, but piped input
+	// is usually slow and interactive, so there one thread is enough.
+	long jobs = reader.mapping() ? sysconf(_SC_NPROCESSORS_ONLN) : 1;
+	if(options[JOBS].arg){
+		string arg = options[JOBS].arg;
+		if(!arg.empty() && arg[0] == '='){
+			arg.erase(0, 1);
+		}
+		char* end;
+		jobs = strtol(arg.c_str(), &end, 10);
+		if(arg.empty() || *end || jobs < 1 || jobs > 1024){
+			cerr << PROGRAM_NAME << ": Invalid number of jobs \""
+					<< arg << "\"!" << endl;
+			cleanUp(-1);
+		}
+	}
+	Pipeline pipeline(reader, coloringEnabled ? &classifier : NULL,
+			jobs > 0 ? jobs : 1);
 
-			cout << line << reset << endl;
-			for(int i = 0; i < htmlFiles.size(); i++){
-				*htmlFiles[i] << line << reset << endl;
-			}
+	if(pipe(interruptPipe)){
+		cerr << PROGRAM_NAME << ": Cannot create pipe: " << strerror(errno)
+				<< endl;
+		cleanUp(-1);
+	}
+	reader.setInterruptFd(interruptPipe[0]);
+
+	// Standard output blocks, unless asked for explicitly.
+	auto queuePolicy = [&](const string& name) {
+		auto iter = queuePolicies.find(name);
+		return iter != queuePolicies.end()
+				? iter->second
+				: name == "-" ? Pipeline::BLOCK : defaultQueuePolicy;
+	};
+
+	// Uncolored outputs of piped input are copied inside kernel.
+	// Others, or these which splice(2) could not write,
+	// go through pipeline.
+	SpliceTee spliceTee(STDIN_FILENO);
+	bool canTee = SpliceTee::canTee(STDIN_FILENO);
+	auto addSpliceOutput = [&](int fd, const string& name) {
+		return canTee && queuePolicy(name) == Pipeline::BLOCK
+				&& spliceTee.addOutput(fd, name);
+	};
+
+	vector<Rotator*> rotators;
+	auto rotator = [&](const string& name) -> Rotator* {
+		if(!rotation.enabled()){
+			return NULL;
+		}
+		rotators.push_back(new Rotator(name, rotation, compressor));
+		return rotators.back();
+	};
+
+	vector<Sink*> sinks;
+	vector<string> sinkNames;
+	vector<bool> sinkTtys;
+	// Terminal sink writes directly to file descriptor.
+	cout << flush;
+	if(coloringEnabled || !addSpliceOutput(STDOUT_FILENO, "-")){
+		sinks.push_back(new TerminalSink(STDOUT_FILENO, coloringEnabled,
+				coloringBold, searchStringToColor));
+		sinkNames.push_back("-");
+		sinkTtys.push_back(isatty(STDOUT_FILENO));
+	}
+	for(int i = 0; i < htmlFiles.size(); i++){
+		sinks.push_back(new HtmlSink(htmlFiles[i], coloringEnabled,
+				coloringBold, searchStringToColor,
+				rotator(htmlFileNames[i])));
+		sinkNames.push_back(htmlFileNames[i]);
+		sinkTtys.push_back(false);
+	}
+	for(int i = 0; i < htmlViewers.size(); i++){
+		sinks.push_back(new ViewerSink(htmlViewers[i], coloringEnabled,
+				coloringBold, searchStringToColor));
+		sinkNames.push_back(htmlViewerNames[i]);
+		sinkTtys.push_back(false);
+	}
+	for(int i = 0; i < files.size(); i++){
+		// Rotated files are switched between batches.
+		if(!rotation.enabled() && addSpliceOutput(files[i], fileNames[i])){
+			continue;
+		}
+		sinks.push_back(new FileSink(files[i], rotator(fileNames[i])));
+		sinkNames.push_back(fileNames[i]);
+		sinkTtys.push_back(isatty(files[i]));
+	}
+	for(size_t i = 0; i < gzipFiles.size(); i++){
+		sinks.push_back(new GzipFileSink(gzipFiles[i]));
+		sinkNames.push_back(gzipFileNames[i]);
+		sinkTtys.push_back(false);
+	}
+	for(int i = 0; i < sinks.size(); i++){
+		const string& name = sinkNames[i];
+		Pipeline::FlushPolicy flush(sinkTtys[i], 1 << 18, flushIdleMs);
+		int err = pipeline.addSink(sinks[i], name, queuePolicy(name), flush);
+		if(err){
+			cerr << PROGRAM_NAME << ": Cannot create spill file for "
+					<< name << ": " << strerror(err) << endl;
+			cleanUp(-1);
+		}
+	}
 
-			for(int i = 0; i < files.size(); i++){
-				*files[i] << line << endl;
-			}
+	int inputError = 0;
+	if(sinks.empty() && !options[STATS]){
+		// Nothing needs lines, so input never comes to user space.
+		spliceTee.setInterruptFd(interruptPipe[0]);
+		inputError = spliceTee.passthrough();
+	}else{
+		if(spliceTee.outputCount()){
+			reader.setTee(&spliceTee);
+		}
+		pipeline.run();
+		inputError = reader.error();
+	}
 
+	for(int i = 0; i < pipeline.sinkCount(); i++){
+		if(pipeline.droppedLines(i)){
+			cerr << PROGRAM_NAME << ": " << pipeline.sinkName(i)
+					<< ": dropped " << pipeline.droppedLines(i)
+					<< " lines" << endl;
 		}
-	}else{
-		string line;
-		while(getline(cin, line)){
+		if(pipeline.spilledLines(i)){
+			cerr << PROGRAM_NAME << ": " << pipeline.sinkName(i)
+					<< ": spilled " << pipeline.spilledLines(i)
+					<< " lines to disk" << endl;
+		}
+		if(pipeline.sinkError(i)){
+			cerr << PROGRAM_NAME << ": " << pipeline.sinkName(i)
+					<< ": " << strerror(pipeline.sinkError(i)) << endl;
+		}
+		if(pipeline.spillError(i)){
+			cerr << PROGRAM_NAME << ": " << pipeline.sinkName(i)
+					<< ": cannot spill to disk: "
+					<< strerror(pipeline.spillError(i)) << endl;
+		}
+	}
 
-			cout << line << endl;
+	for(int i = 0; i < spliceTee.outputCount(); i++){
+		if(spliceTee.outputError(i)){
+			cerr << PROGRAM_NAME << ": " << spliceTee.outputName(i)
+					<< ": " << strerror(spliceTee.outputError(i)) << endl;
+		}
+	}
 
-			for(int i = 0; i < htmlFiles.size(); i++){
-				*htmlFiles[i] << line << endl;
-			}
+	for(Sink* sink: sinks){
+		delete sink;
+	}
+	for(Rotator* r: rotators){
+		if(r->error()){
+			cerr << PROGRAM_NAME << ": " << r->name() << ": cannot rotate: "
+					<< strerror(r->error()) << endl;
+		}
+		delete r;
+	}
+	// Compressed files are finished, so their sizes are known.
+	for(size_t i = 0; i < gzipFiles.size(); i++){
+		int err = gzipFiles[i]->error();
+		if(!gzipFiles[i]->close() && !err){
+			cerr << PROGRAM_NAME << ": " << gzipFileNames[i] << ": "
+					<< strerror(gzipFiles[i]->error()) << endl;
+		}
+	}
+	for(size_t i = 0; i < htmlFiles.size(); i++){
+		if(isCompressed(htmlFileNames[i])){
+			htmlFiles[i]->close();
+		}
+	}
+	if(compressor){
+		compressor->finish();
+		if(compressor->error()){
+			cerr << PROGRAM_NAME << ": " << compressor->errorFile()
+					<< ": cannot compress: " << strerror(compressor->error())
+					<< endl;
+		}
+	}
 
-			for(int i = 0; i < files.size(); i++){
-				*files[i] << line << endl;
-			}
+	if(inputError){
+		cerr << PROGRAM_NAME << ": " << inputName << ": "
+				<< strerror(inputError) << endl;
+		cleanUp(1);
+	}
 
+	if(options[STATS]){
+		cerr << PROGRAM_NAME << ": lines: " << pipeline.lineCount()
+				<< ", colored: " << pipeline.coloredCount() << endl;
+		cerr << PROGRAM_NAME << ": prefilter: "
+				<< classifier.prefilterImplementation() << endl;
+		cerr << PROGRAM_NAME << ": DFA states: " << pipeline.dfaStates()
+				<< ", DFA cache flushes: " << pipeline.dfaCacheFlushes()
+				<< endl;
+		for(size_t i = 0; i < gzipFiles.size(); i++){
+			printCompression(gzipFileNames[i], *gzipFiles[i]);
+		}
+		for(size_t i = 0; i < htmlFiles.size(); i++){
+			if(isCompressed(htmlFileNames[i])){
+				printCompression(htmlFileNames[i],
+						htmlFiles[i]->rdbuf()->gzip());
+			}
 		}
 	}
 
-	cleanUp(0);
+	cleanUp(interruptSignal);
 }
 
@@ -40,10 +40,30 @@ const option::Descriptor usage[] = {
 	{ NO_BOLD,           0,  "",           "no-bold", option::Arg::None,     "      --no-bold           \tno bold output" },
 	{ COLOR_SCHEMES,     0, "c",     "color-schemes", option::Arg::Optional, "  -c, --color-schemes     \tcolor schemes, separeted with \",\"\n" },
 	{ OPT_CONFIG_FILE,   0,  "",            "config", option::Arg::Optional, "      --config            \tconfiguration file" },
+	{ STATS,             0,  "",             "stats", option::Arg::None,     "      --stats             \tprint matching statistics to standard error at exit" },
+	{ QUEUE_POLICY,      0,  "",      "queue-policy", option::Arg::Optional, "      --queue-policy      \t[FILE=]POLICY, what to do when output is too slow:\n"
+	                                                                          "                          \tblock, drop-oldest or spill-to-disk,\n"
+	                                                                          "                          \tfor FILE or for all FILEs, default is block" },
+	{ FLUSH_IDLE,        0,  "",        "flush-idle", option::Arg::Optional, "      --flush-idle        \tMS, write out buffered lines when input is idle\n"
+	                                                                          "                          \tfor that many milliseconds, default is 100" },
+	{ INPUT,             0,  "",             "input", option::Arg::Optional, "      --input             \tread FILE instead of standard input" },
+	{ JOBS,              0, "j",              "jobs", option::Arg::Optional, "  -j, --jobs              \tN, number of threads coloring lines, default is\n"
+	                                                                          "                          \tnumber of CPUs for file input and 1 otherwise" },
+	{ HTML_PAGE_LINES,   0,  "",   "html-page-lines", option::Arg::Optional, "      --html-page-lines   \tN, split HTML files to pages of N lines, with index\n"
+	                                                                          "                          \tof pages in FILE itself" },
+	{ HTML_PAGE_SIZE,    0,  "",    "html-page-size", option::Arg::Optional, "      --html-page-size    \tMB, split HTML files to pages of MB megabytes" },
+	{ HTML_VIEWER,       0,  "",       "html-viewer", option::Arg::Optional, "      --html-viewer       \tHTML page which loads only lines in view, for very\n"
+	                                                                          "                          \tbig logs, with lines in directory next to it" },
+	{ ROTATE_SIZE,       0,  "",       "rotate-size", option::Arg::Optional, "      --rotate-size       \tMB, start new FILEs and HTML files when they have\n"
+	                                                                          "                          \tMB megabytes, closed ones are renamed to\n"
+	                                                                          "                          \tFILE.0001, FILE.0002, ... and compressed with gzip" },
+	{ ROTATE_INTERVAL,   0,  "",   "rotate-interval", option::Arg::Optional, "      --rotate-interval   \tS, start new FILEs and HTML files every S seconds" },
+	{ KEEP,              0,  "",              "keep", option::Arg::Optional, "      --keep              \tN, keep only N newest closed FILEs and HTML files" },
     { HELP,              0, "h",              "help", option::Arg::None,     "  -h, --help              \tdisplay this help and exit" },
     { VERSION,           0,  "",           "version", option::Arg::None,     "      --version           \toutput version information and exit" },
 
     { UNKNOWN,           0,  "",                  "", option::Arg::None,     concat({"\nIf a FILE is -, copy again to standard output."
+                                                                              "\nFILEs and HTML files ending with .gz are compressed with gzip."
                                                                               "\nBy default all logs colorings are enabled."
                                                                               "\nEnabling any of specific logs turns off all others.\n\n"
                                                                               "Report ", PROGRAM_NAME, " bugs to milos.subotic.sm@gmail.com\n"}) },
@@ -23,7 +23,9 @@
 
 enum optionIndex{
 	UNKNOWN, APPEND, IGNORE_INTERRUPTS, HTML_OUTPUT, NO_COLORS, NO_BOLD,
-	COLOR_SCHEMES, OPT_CONFIG_FILE, HELP, VERSION
+	COLOR_SCHEMES, OPT_CONFIG_FILE, STATS, QUEUE_POLICY, FLUSH_IDLE, INPUT,
+	JOBS, HTML_PAGE_LINES, HTML_PAGE_SIZE, HTML_VIEWER,
+	ROTATE_SIZE, ROTATE_INTERVAL, KEEP, HELP, VERSION
 };
 
 ///////////////////////////////////////////////////////////////////////////////
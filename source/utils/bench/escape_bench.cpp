@@ -0,0 +1,182 @@
+/**
+ * @file escape_bench.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief HTML escaping of HtmlEscape::escapeTo() against old
+ * character by character loop of html_filebuf.
+ *
+ * Usage: escape_bench [file...]
+ * Every file is escaped line by line, as html_filebuf gets it.
+ * Without files generated log text and dense text are used.
+ * Old loop stops at NUL, so it does less work on text with NUL.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "HtmlEscape.h"
+#include "TimeMeasure.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Escaping of html_filebuf::xsputn() before escapeTo().
+ * Bytes above 127 never got to snprintf(), since char is signed on x86,
+ * but branch is kept so loop costs as much as it did.
+ */
+static streamsize oldEscape(streambuf* out, const char* s, streamsize n){
+	streamsize i;
+	for(i = 0; i < n && *s; i++, s++){
+		int c = *s;
+		switch(c){
+		case '<': out->sputn("&lt;", 4); break;
+		case '>': out->sputn("&gt;", 4); break;
+		case '"': out->sputn("&quot;", 6); break;
+		case '&': out->sputn("&amp;", 5); break;
+		default:
+			if(c > 127){
+				char buffer[9];
+				int stored = snprintf(buffer, 9, "&#x%4x;", c);
+				out->sputn(buffer, stored);
+			}else{
+				out->sputc(c);
+			}
+			break;
+		}
+	}
+	return i;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Text like build log, with few bytes to escape.
+ */
+static string logText(size_t size){
+	const char* lines[] = {
+		"src/main.cpp:42:10: warning: unused variable 'x' [-Wunused-variable]\n",
+		"g++ -std=c++11 -O2 -Wall -Isource/utils/include -c main.cpp -o main.o\n",
+		"In instantiation of 'void f(T) [with T = std::vector<int>]':\n",
+		"  required from here\n",
+		"make[2]: Leaving directory '/home/user/build' && echo done\n",
+	};
+	string text;
+	for(size_t i = 0; text.size() < size; i++){
+		text += lines[i % (sizeof(lines) / sizeof(lines[0]))];
+	}
+	return text;
+}
+
+/**
+ * Random text where about 1 in 8 bytes is escaped,
+ * with some UTF-8 characters and carriage returns.
+ */
+static string denseText(size_t size){
+	const char* symbols[] = {
+		"r", "r", "r", "r", "n", "n", "a", "a", " ", " ",
+		"b", "c", "e", "g", "i", "o", "w", "x", "y", "z",
+		"0", "1", "2", "3", "4", "5", "6", "7", "8", "9",
+		":", "/", "\r", "\xc3\xa9", "<", ">", "&", "\"",
+	};
+	string text;
+	srand(1);
+	while(text.size() < size){
+		for(int i = 0; i < 96; i++){
+			text += symbols[rand() % (sizeof(symbols) / sizeof(symbols[0]))];
+		}
+		text += '\n';
+	}
+	return text;
+}
+
+/**
+ * Escape lines with table and return speed in MB/s.
+ */
+static double escapeTo(const HtmlEscape::Table& table, const string& text,
+		const vector<pair<size_t, size_t>>& lines){
+	stringbuf out;
+	Time start = getTimeMonotonic();
+	for(const pair<size_t, size_t>& l: lines){
+		HtmlEscape::escapeTo(table, text.data() + l.first, l.second,
+				[&out](const char* p, size_t n) { out.sputn(p, n); });
+	}
+	return text.size() / 1e6 / (getTimeMonotonic() - start);
+}
+
+/**
+ * Escape text line by line with old loop and with escapeTo(),
+ * without and with UTF-8 checking of html_filebuf, and print speeds.
+ */
+static void bench(const string& name, const string& text){
+	static const HtmlEscape::Table plain(true, false, true);
+	static const HtmlEscape::Table utf8(true, false, true, true);
+	vector<pair<size_t, size_t>> lines;
+	size_t begin = 0;
+	for(size_t i = 0; i < text.size(); i++){
+		if(text[i] == '\n'){
+			lines.push_back(make_pair(begin, i + 1 - begin));
+			begin = i + 1;
+		}
+	}
+	double best[3] = { 0, 0, 0 };
+	// Best of few runs, so one slow run does not count.
+	for(int run = 0; run < 3; run++){
+		stringbuf out;
+		Time start = getTimeMonotonic();
+		for(const pair<size_t, size_t>& l: lines){
+			oldEscape(&out, text.data() + l.first, l.second);
+		}
+		double speed[3] = {
+			text.size() / 1e6 / (getTimeMonotonic() - start),
+			escapeTo(plain, text, lines),
+			escapeTo(utf8, text, lines)
+		};
+		for(int i = 0; i < 3; i++){
+			if(speed[i] > best[i]){
+				best[i] = speed[i];
+			}
+		}
+	}
+	printf("%-16s %6.1f MB  old %7.1f MB/s  escapeTo (%s) %7.1f MB/s"
+			"  with UTF-8 %7.1f MB/s\n", name.c_str(), text.size() / 1e6,
+			best[0], plain.implementation(), best[1], best[2]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv){
+	if(argc < 2){
+		bench("log text", logText(30 << 20));
+		bench("dense text", denseText(30 << 20));
+		return 0;
+	}
+	for(int i = 1; i < argc; i++){
+		ifstream file(argv[i]);
+		if(!file){
+			fprintf(stderr, "escape_bench: Cannot open \"%s\"!\n", argv[i]);
+			return 1;
+		}
+		ostringstream text;
+		text << file.rdbuf();
+		bench(argv[i], text.str());
+	}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
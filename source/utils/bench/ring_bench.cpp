@@ -0,0 +1,212 @@
+/**
+ * @file ring_bench.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Throughput and latency of spsc_ring and mpmc_ring.
+ *
+ * Usage: ring_bench [max_threads]
+ * mpmc_ring is measured with 1 to max_threads producers and as many
+ * consumers. Without argument max_threads is 4.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "stl_extensions/spsc_ring.h"
+#include "stl_extensions/mpmc_ring.h"
+#include "thread.h"
+#include "TimeMeasure.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+using namespace stl_extensions;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Elements passed in every throughput test.
+static const size_t COUNT = 4000000;
+/// Round trips in latency test.
+static const size_t ROUND_TRIPS = 200000;
+
+static void report(const char* name, double seconds){
+	printf("%-28s %10.2f Mops/s\n", name, COUNT / seconds / 1e6);
+}
+
+/**
+ * Print median and 99th percentile of latencies in microseconds.
+ */
+static void reportLatency(const char* name, vector<double>& latencies){
+	if(latencies.empty()){
+		return;
+	}
+	sort(latencies.begin(), latencies.end());
+	printf("%-28s %10.2f us median %10.2f us p99\n", name,
+			latencies[latencies.size() / 2] * 1e6,
+			latencies[latencies.size() * 99 / 100] * 1e6);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * One producer and one consumer, element by element or in batches.
+ */
+static bool spscThroughput(size_t batch){
+	spsc_ring<size_t> ring(1024);
+	Time start = getTimeMonotonic();
+	function<void()> producer = [&]() {
+		vector<size_t> values(batch);
+		for(size_t i = 0; i < COUNT; i += batch){
+			for(size_t j = 0; j < batch; j++){
+				values[j] = i + j;
+			}
+			ring.push_n(values.data(), batch);
+		}
+	};
+	thread t(producer);
+	vector<size_t> values(batch);
+	bool ordered = true;
+	for(size_t got = 0; got < COUNT;){
+		size_t n = ring.pop_n(values.data(), batch);
+		for(size_t j = 0; j < n; j++){
+			ordered = ordered && values[j] == got + j;
+		}
+		got += n;
+	}
+	t.join();
+	char name[64];
+	snprintf(name, sizeof(name), "spsc batch %zu", batch);
+	report(name, getTimeMonotonic() - start);
+	return ordered;
+}
+
+/**
+ * Latency of handing element over, as half of round trip
+ * through two rings.
+ */
+static void spscLatency(){
+	spsc_ring<size_t> there(64);
+	spsc_ring<size_t> back(64);
+	function<void()> echo = [&]() {
+		size_t value;
+		for(size_t i = 0; i < ROUND_TRIPS; i++){
+			there.pop(value);
+			back.push(value);
+		}
+	};
+	thread t(echo);
+	vector<double> latencies;
+	latencies.reserve(ROUND_TRIPS);
+	for(size_t i = 0; i < ROUND_TRIPS; i++){
+		size_t value;
+		Time start = getTimeMonotonic();
+		there.push(i);
+		back.pop(value);
+		latencies.push_back((getTimeMonotonic() - start) / 2);
+	}
+	t.join();
+	reportLatency("spsc one way", latencies);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Producers push time of push, and consumers measure how long
+ * element was in ring. Negative time stops consumer.
+ */
+static void mpmcContention(size_t threads, size_t batch){
+	mpmc_ring<double> ring(256);
+	size_t perProducer = COUNT / threads;
+	vector<vector<double>> latencies(threads);
+	vector<thread*> producers;
+	vector<thread*> consumers;
+	vector<function<void()>> calls;
+	calls.reserve(2 * threads);
+	Time start = getTimeMonotonic();
+	for(size_t c = 0; c < threads; c++){
+		calls.push_back([&ring, &latencies, c, batch]() {
+			vector<double> values(batch);
+			size_t got = 0;
+			while(true){
+				size_t n = ring.pop_n(values.data(), batch);
+				Time now = getTimeMonotonic();
+				for(size_t j = 0; j < n; j++){
+					if(values[j] < 0){
+						return;
+					}
+					// Every element would measure mostly clock itself.
+					if(got++ % 64 == 0){
+						latencies[c].push_back(now - values[j]);
+					}
+				}
+			}
+		});
+		consumers.push_back(new thread(calls.back()));
+	}
+	for(size_t p = 0; p < threads; p++){
+		calls.push_back([&ring, perProducer, batch]() {
+			vector<double> values(batch);
+			for(size_t i = 0; i < perProducer; i += batch){
+				Time now = getTimeMonotonic();
+				fill(values.begin(), values.end(), now);
+				ring.push_n(values.data(), batch);
+			}
+		});
+		producers.push_back(new thread(calls.back()));
+	}
+	for(thread* t: producers){
+		t->join();
+		delete t;
+	}
+	for(size_t c = 0; c < threads; c++){
+		ring.push(-1);
+	}
+	for(thread* t: consumers){
+		t->join();
+		delete t;
+	}
+	double seconds = getTimeMonotonic() - start;
+
+	char name[64];
+	snprintf(name, sizeof(name), "mpmc %zux%zu batch %zu", threads, threads,
+			batch);
+	report(name, seconds);
+	vector<double> all;
+	for(const vector<double>& l: latencies){
+		all.insert(all.end(), l.begin(), l.end());
+	}
+	reportLatency(name, all);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv){
+	size_t max = argc > 1 ? strtoul(argv[1], 0, 10) : 4;
+	if(max < 1){
+		max = 1;
+	}
+	if(!spscThroughput(1) || !spscThroughput(32)){
+		fprintf(stderr, "ring_bench: spsc_ring changed order!\n");
+		return 1;
+	}
+	spscLatency();
+	for(size_t threads = 1; threads <= max; threads *= 2){
+		mpmcContention(threads, 1);
+		mpmcContention(threads, 16);
+	}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
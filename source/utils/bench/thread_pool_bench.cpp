@@ -0,0 +1,111 @@
+/**
+ * @file thread_pool_bench.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Scaling of thread_pool from 1 to N workers.
+ *
+ * Usage: thread_pool_bench [max_workers]
+ * Without argument goes up to number of CPUs.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "thread_pool.h"
+#include "TimeMeasure.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <atomic>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Some work which compiler could not throw away.
+ */
+static unsigned work(unsigned seed, int rounds){
+	for(int i = 0; i < rounds; i++){
+		seed = seed * 1103515245 + 12345;
+	}
+	return seed;
+}
+
+/**
+ * Fork/join over range, like recursive rendering of big file.
+ */
+static unsigned forkJoin(thread_pool& pool, unsigned first, unsigned last){
+	if(last - first <= 64){
+		unsigned s = 0;
+		for(unsigned i = first; i < last; i++){
+			s += work(i, 2000);
+		}
+		return s;
+	}
+	unsigned middle = first + (last - first) / 2;
+	unsigned left = 0;
+	task_group group(pool);
+	group.run([&]() { left = forkJoin(pool, first, middle); });
+	unsigned right = forkJoin(pool, middle, last);
+	group.wait();
+	return left + right;
+}
+
+/**
+ * Many independent small tasks submitted from outside of pool.
+ */
+static unsigned flat(thread_pool& pool, unsigned tasks){
+	atomic<unsigned> s(0);
+	task_group group(pool);
+	for(unsigned i = 0; i < tasks; i++){
+		group.run([&s, i]() { s += work(i, 2000); });
+	}
+	group.wait();
+	return s;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv){
+	size_t max = argc > 1 ? strtoul(argv[1], 0, 10) : thread_pool::cpu_count();
+	if(max < 1){
+		max = 1;
+	}
+	const unsigned items = 1 << 16;
+	double forkJoinBase = 0;
+	double flatBase = 0;
+	printf("%8s %14s %8s %14s %8s\n", "workers", "fork/join [s]", "speedup",
+			"flat [s]", "speedup");
+	for(size_t workers = 1; workers <= max; workers++){
+		thread_pool pool(workers);
+		Time start = getTimeMonotonic();
+		unsigned a = forkJoin(pool, 0, items);
+		double forkJoinTime = getTimeMonotonic() - start;
+		start = getTimeMonotonic();
+		unsigned b = flat(pool, items);
+		double flatTime = getTimeMonotonic() - start;
+		if(a != b){
+			fprintf(stderr, "thread_pool_bench: results differ!\n");
+			return 1;
+		}
+		if(workers == 1){
+			forkJoinBase = forkJoinTime;
+			flatBase = flatTime;
+		}
+		printf("%8zu %14.3f %8.2f %14.3f %8.2f\n", workers,
+				forkJoinTime, forkJoinBase / forkJoinTime,
+				flatTime, flatBase / flatTime);
+	}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
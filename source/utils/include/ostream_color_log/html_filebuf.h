@@ -18,9 +18,14 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ctime>
+#include <string>
 #include <fstream>
+#include <set>
 
 #include <ostream_color_log/ostream_coloring.h>
+#include <ostream_color_log/text_style.h>
+#include <stl_extensions/gzip_streambuf.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -34,10 +39,23 @@ namespace ostream_color_log {
 			ostream_attributes attribute);
 	html_ofstream& operator<<(html_ofstream& hofs,
 			_OstreamAttributeAndColorFormat format);
+	html_ofstream& operator<<(html_ofstream& hofs,
+			const text_style& style);
 
 	/**
 	 * @class html_filebuf
-	 * @brief
+	 * @brief Escapes text to HTML file. Every style have CSS class,
+	 * and element with class is opened only when style of text
+	 * changes, so lines of same style share one element.
+	 * File could be split to pages, so browser opens only small part
+	 * of big log. Then file itself is index with table of pages,
+	 * and row of page is updated as page is written.
+	 * End of file is written on every sync() and then written over
+	 * by next text, so file is valid HTML while it is written.
+	 * File opened for appending goes on with body of earlier run
+	 * in place of its end, so it stays one document.
+	 * File with name ending with .gz is compressed while it is written,
+	 * and it could not be split to pages.
 	 */
 	class html_filebuf : public std::streambuf {
 	public:
@@ -48,6 +66,8 @@ namespace ostream_color_log {
 				ostream_attributes attribute);
 		friend html_ofstream& operator<<(html_ofstream& hofs,
 				_OstreamAttributeAndColorFormat format);
+		friend html_ofstream& operator<<(html_ofstream& hofs,
+				const text_style& style);
 
 	public:
 		html_filebuf();
@@ -64,10 +84,76 @@ namespace ostream_color_log {
 				ostream_colors background,
 				ostream_attributes attribute);
 
+		/**
+		 * Write escaped text to other buffer, without HTML header
+		 * and footer, so text could be rendered in parts and put
+		 * to file later with write_html().
+		 * @param out buffer to write to, not owned.
+		 */
+		html_filebuf* open(
+				std::streambuf* out,
+				ostream_colors foreground,
+				ostream_colors background,
+				ostream_attributes attribute);
+
+		/**
+		 * Same as above, but style starts as after reset.
+		 */
+		html_filebuf* open(std::streambuf* out);
+
 		html_filebuf* close();
 
+		/**
+		 * Split file to pages name.0001.html, name.0002.html, ...
+		 * without .html at end of name, and write index of pages
+		 * to file itself. Must be called before open().
+		 * Page is finished when it have at least max_lines lines
+		 * or max_bytes bytes, at start of next write.
+		 * @param max_lines 0 for no limit.
+		 * @param max_bytes 0 for no limit.
+		 */
+		void set_paging(size_t max_lines, size_t max_bytes);
+
+		/**
+		 * Count lines which are errors, for page which was
+		 * written last. Index shows them for every page.
+		 */
+		void count_errors(size_t errors){
+			_pageErrors += errors;
+		}
+
+		/**
+		 * Write already escaped HTML as it is.
+		 * Styles used in it must be declared with declare_style().
+		 */
+		std::streamsize write_html(const char* s, std::streamsize n);
+
+		/**
+		 * Write already escaped HTML, which could start with element
+		 * of style first and leave element of style last open,
+		 * as text rendered without close() does. If first is style
+		 * of written text, its element goes on, so lines of same style
+		 * still share one element, however text is split.
+		 */
+		std::streamsize write_html(const char* s, std::streamsize n,
+				const text_style& first, const text_style& last);
+
+		/**
+		 * Declare CSS class of style which will be used. Styles
+		 * declared before any text is written go to head of file.
+		 */
+		void declare_style(const text_style& style);
+
 		bool is_open() const{
-			return _filebuf.is_open();
+			return _filebuf.is_open() || _gzip.is_open();
+		}
+
+		/**
+		 * @return buffer compressing file, which is not used
+		 * if file is not compressed.
+		 */
+		const stl_extensions::gzip_streambuf& gzip() const{
+			return _gzip;
 		}
 
 		///////////////////////////////
@@ -82,22 +168,134 @@ namespace ostream_color_log {
 		///////////////////////////////
 
 	protected:
+		/**
+		 * @return if text goes to file, not to other buffer.
+		 */
+		bool writingFile() const{
+			return _out == &_filebuf || _out == &_gzip;
+		}
+
 		std::streamsize directWrite(const char* s);
 		std::streamsize directWrite(const std::string& s);
-		static const char* makeColorString(ostream_colors color);
-		void writeAttributeAndColors();
 		void setForeground(ostream_colors foreground);
 		void setBackground(ostream_colors background);
 		void setAttribute(ostream_attributes attribute);
 
+		/**
+		 * Open element of current style, if it differs from style
+		 * of written text.
+		 */
+		void writeStyle();
+
+		/**
+		 * Close element of written style.
+		 */
+		void closeStyle();
+
+		/**
+		 * @return start of element of style.
+		 */
+		static std::string openTag(const text_style& style);
+
+		/**
+		 * Finish head of file before first body text.
+		 */
+		void startBody();
+
+		/**
+		 * Write head of HTML file up to declared styles.
+		 */
+		void startHead(const std::string& title);
+
+		/**
+		 * Start next page when page is full.
+		 */
+		void nextPageIfFull();
+
+		/**
+		 * Open next page and add its row to index.
+		 * @return false if page could not be opened.
+		 */
+		bool openPage();
+
+		/**
+		 * Finish page and its row in index.
+		 * @param next if there is next page to link to.
+		 */
+		void closePage(bool next);
+
+		/**
+		 * Write row of current page to index,
+		 * and end of index after it.
+		 * @param done if page is finished, then next row goes after it.
+		 */
+		void writeIndexRow(bool done);
+
+		/**
+		 * Write end of file after text, so file is valid while
+		 * it is written, and go back to write next text over it.
+		 */
+		void writeFooter();
+
+		/**
+		 * Find end of file written by earlier run.
+		 * @return where end starts, or -1 if file does not end with it.
+		 */
+		std::streamoff findFooter();
+
+		/**
+		 * Read CSS classes declared in head of file written
+		 * by earlier run, so they are not declared again.
+		 */
+		void readEarlierClasses();
+
+		std::string pageName(size_t page) const;
+
+		/**
+		 * Count written text for paging.
+		 */
+		void countText(const char* s, std::streamsize n);
+
 		///////////////////////////////
 
 	protected:
-		std::string _attributes;
-		std::string _foreground;
-		std::string _background;
+		/// Style of text outside of any element.
+		text_style _base;
+		/// Style set by manipulators.
+		text_style _style;
+		/// Style of written text.
+		text_style _written;
+		/// Head of file is not finished yet.
+		bool _headOpen;
+		/// Styles with CSS class in file.
+		std::set<text_style> _declared;
+		/// CSS classes in head of file written by earlier run.
+		std::set<std::string> _earlierClasses;
 
 		std::filebuf _filebuf;
+		stl_extensions::gzip_streambuf _gzip;
+		/// Where text goes, _filebuf, _gzip or other buffer.
+		std::streambuf* _out;
+
+		/// Page limits, both 0 if file is not split to pages.
+		size_t _maxLines;
+		size_t _maxBytes;
+		/// Name of index file and of pages without .html.
+		std::string _indexName;
+		std::string _pagePrefix;
+		std::filebuf _index;
+		/// Where row of current page starts in index.
+		std::streamoff _indexRow;
+		/// Number of current page, counting from 1.
+		size_t _page;
+		size_t _pageLines;
+		size_t _pageBytes;
+		size_t _pageErrors;
+		/// Time of first and last text on page, 0 before any.
+		time_t _pageFirst;
+		time_t _pageLast;
+		/// Last written text ended with new line.
+		bool _lineStart;
 	};
 
 } // namespace ostream_color_log
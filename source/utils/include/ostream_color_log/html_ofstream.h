@@ -42,6 +42,17 @@ namespace ostream_color_log {
 				ostream_attributes attribute = nothing);
 
 
+		/**
+		 * Render to other buffer instead of file.
+		 * @see html_filebuf::open()
+		 */
+		void open(
+				std::streambuf* out,
+				ostream_colors foreground,
+				ostream_colors background,
+				ostream_attributes attribute);
+		void open(std::streambuf* out);
+
 		void close();
 
 		html_filebuf* rdbuf() const{
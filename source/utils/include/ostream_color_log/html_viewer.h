@@ -0,0 +1,146 @@
+/**
+ * @file html_viewer.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief HTML page showing only visible lines, which are loaded
+ * from data files in chunks.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef HTML_VIEWER_H_
+#define HTML_VIEWER_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <ostream_color_log/text_style.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ostream_color_log {
+
+	/**
+	 * @class html_viewer
+	 * @brief Writes page name.html, which is written only once, and
+	 * data directory name_files next to it. Lines are written to chunk
+	 * files of CHUNK_LINES lines, each with style id of every line,
+	 * and index file tells page how many lines there is and
+	 * CSS of styles. Page lays out only lines in its window and loads
+	 * chunks as they are scrolled to. Data files are JavaScript which
+	 * page runs with script elements, so page works from local file
+	 * system without server. Page reloads index from time to time,
+	 * so it shows lines which came after it was opened.
+	 */
+	class html_viewer {
+	public:
+		/// Number of lines in one chunk file.
+		static const size_t CHUNK_LINES = 4096;
+
+		html_viewer();
+		~html_viewer();
+
+		html_viewer(const html_viewer&) = delete;
+		const html_viewer& operator=(const html_viewer&) = delete;
+
+		///////////////////////////////
+
+	public:
+		/**
+		 * Create data directory and write page and empty index.
+		 * @param name name of page.
+		 * @return errno of failure or 0.
+		 */
+		int open(const std::string& name);
+
+		/**
+		 * Finish last chunk and index.
+		 */
+		void close();
+
+		/**
+		 * Give CSS class to style id. Id 0 is style of lines
+		 * without any style set.
+		 */
+		void declare_style(size_t id, const text_style& style);
+
+		/**
+		 * Render line for write_line(), as JavaScript string
+		 * followed by new line. Could be called from any thread.
+		 * @param out string which rendered line is appended to.
+		 */
+		static void render_line(const char* s, size_t n, std::string& out);
+
+		/**
+		 * Add line rendered with render_line().
+		 * @param rendered rendered line with its new line.
+		 * @param style id of style of line.
+		 */
+		void write_line(const char* rendered, size_t n, size_t style);
+
+		/**
+		 * Write out last chunk, which is not full yet, and index,
+		 * so page could show all lines written until now.
+		 */
+		void flush();
+
+		/**
+		 * @return number of bytes in chunk which is not written out.
+		 */
+		size_t pending() const noexcept {
+			return _pending;
+		}
+
+		/**
+		 * @return errno of first write failure or 0.
+		 */
+		int error() const noexcept {
+			return _error;
+		}
+
+		///////////////////////////////
+
+	protected:
+		void writeChunk();
+		void writeIndex();
+
+		/**
+		 * Write whole file under temporary name and rename it,
+		 * so page never loads half written file.
+		 */
+		void writeFile(const std::string& name, const std::string& text);
+
+		///////////////////////////////
+
+	protected:
+		/// Data directory, with / at end.
+		std::string _dir;
+		bool _open;
+		/// CSS class of every style id.
+		std::vector<std::string> _classes;
+		std::string _css;
+		/// Lines of current chunk and their style ids.
+		std::string _chunkText;
+		std::string _chunkStyles;
+		size_t _chunk;
+		size_t _chunkLines;
+		/// Lines in all finished chunks.
+		size_t _lines;
+		size_t _pending;
+		int _error;
+	};
+
+} // namespace ostream_color_log
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // HTML_VIEWER_H_
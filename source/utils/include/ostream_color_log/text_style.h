@@ -0,0 +1,238 @@
+/**
+ * @file text_style.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Colors and attributes of text, and registry of used styles.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef TEXT_STYLE_H_
+#define TEXT_STYLE_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <deque>
+#include <map>
+#include <atomic>
+
+#include <ostream_color_log/ostream_coloring.h>
+#include "thread.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ostream_color_log {
+
+	/**
+	 * @class text_color
+	 * @brief Color which is not set, one of 8 basic colors,
+	 * one of 256 palette colors or 24 bit RGB color.
+	 */
+	class text_color {
+	public:
+		enum kind_t {
+			NONE,
+			BASIC,
+			INDEXED,
+			RGB
+		};
+
+		text_color()
+				: value(0) {
+		}
+
+		text_color(ostream_colors color)
+				: value(BASIC << 24 | (color - black)) {
+		}
+
+		static text_color indexed(uint8_t index) {
+			text_color c;
+			c.value = INDEXED << 24 | index;
+			return c;
+		}
+
+		static text_color rgb(uint8_t r, uint8_t g, uint8_t b) {
+			text_color c;
+			c.value = RGB << 24 | r << 16 | g << 8 | b;
+			return c;
+		}
+
+		/**
+		 * Parse color name like "red", palette index from 0 to 255
+		 * or RGB color as "#rrggbb".
+		 * @return false if text is not color.
+		 */
+		static bool parse(const std::string& text, text_color& color);
+
+		kind_t kind() const {
+			return kind_t(value >> 24);
+		}
+
+		bool operator==(const text_color& other) const {
+			return value == other.value;
+		}
+
+		bool operator!=(const text_color& other) const {
+			return value != other.value;
+		}
+
+		bool operator<(const text_color& other) const {
+			return value < other.value;
+		}
+
+		/**
+		 * @return short code of color for CSS class names.
+		 */
+		std::string code() const;
+
+		/**
+		 * @return CSS color.
+		 */
+		std::string css() const;
+
+		/**
+		 * @return SGR parameters setting color.
+		 */
+		std::string ansi(bool background) const;
+
+	public:
+		/// Kind in top byte, and color in rest.
+		uint32_t value;
+	};
+
+	/**
+	 * @class text_style
+	 * @brief Colors and attributes of text.
+	 */
+	class text_style {
+	public:
+		/// Attribute bits.
+		enum {
+			BOLD = 1,
+			UNDERLINE = 2,
+			BLINK = 4,
+			HIDDEN = 8
+		};
+
+		text_style()
+				: attributes(0) {
+		}
+
+		text_style(
+				text_color foreground,
+				text_color background,
+				ostream_attributes attribute)
+				: foreground(foreground), background(background),
+				attributes(0) {
+			add(attribute);
+		}
+
+		/**
+		 * Add attribute, reset clears colors and attributes.
+		 */
+		void add(ostream_attributes attribute);
+
+		bool operator==(const text_style& other) const {
+			return foreground == other.foreground
+					&& background == other.background
+					&& attributes == other.attributes;
+		}
+
+		bool operator!=(const text_style& other) const {
+			return !(*this == other);
+		}
+
+		bool operator<(const text_style& other) const {
+			if(foreground != other.foreground){
+				return foreground < other.foreground;
+			}
+			if(background != other.background){
+				return background < other.background;
+			}
+			return attributes < other.attributes;
+		}
+
+		/**
+		 * @return CSS class name, same for same style in every run.
+		 */
+		std::string css_class() const;
+
+		/**
+		 * @return CSS declarations of style.
+		 */
+		std::string css() const;
+
+		/**
+		 * @return escape sequence setting style on terminal
+		 * after reset, empty for style without anything set.
+		 */
+		std::string ansi() const;
+
+	public:
+		text_color foreground;
+		text_color background;
+		uint8_t attributes;
+	};
+
+	/**
+	 * @class style_registry
+	 * @brief Styles used by process, numbered in order of first use.
+	 * Style is rendered for terminal once, when it is added, so writing
+	 * it is only copying of bytes. Rendering threads add styles and
+	 * HTML file declares new ones before it writes rendered text.
+	 */
+	class style_registry {
+	public:
+		static style_registry& instance();
+
+		/**
+		 * Add style if it is not added yet.
+		 * @return id of style.
+		 */
+		size_t intern(const text_style& style);
+
+		/**
+		 * @return number of styles.
+		 */
+		size_t size() const noexcept {
+			return _size.load(std::memory_order_acquire);
+		}
+
+		text_style at(size_t id);
+
+		/**
+		 * @return escape sequence of style, rendered in advance.
+		 */
+		std::string ansi(size_t id);
+
+	protected:
+		style_registry()
+				: _size(0) {
+		}
+
+		class entry {
+		public:
+			text_style style;
+			std::string ansi;
+		};
+
+		std::map<text_style, size_t> _ids;
+		std::deque<entry> _entries;
+		std::atomic<size_t> _size;
+		mutex _mutex;
+	};
+
+} // namespace ostream_color_log
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // TEXT_STYLE_H_
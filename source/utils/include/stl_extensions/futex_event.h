@@ -0,0 +1,163 @@
+/**
+ * @file futex_event.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Waiting for condition, first spinning and then sleeping on futex.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef FUTEX_EVENT_H_
+#define FUTEX_EVENT_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <climits>
+#include <cerrno>
+#include <ctime>
+#include <atomic>
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace stl_extensions {
+
+	/**
+	 * Tell CPU that thread is spinning.
+	 */
+	inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#endif
+	}
+
+	/**
+	 * @class futex_event
+	 * @brief Threads wait on it for some condition, and thread which
+	 * makes condition true notifies them.
+	 * Waiting spins for short time first, since other side is usually
+	 * quick, and then sleeps on futex. Notify is only memory fence
+	 * when nobody sleeps, so it costs no system call.
+	 */
+	class futex_event {
+	public:
+		/// Number of condition checks before going to sleep.
+		static const int SPIN_COUNT = 128;
+
+		futex_event()
+				: _epoch(0), _sleepers(0) {
+		}
+
+		futex_event(const futex_event&) = delete;
+		const futex_event& operator=(const futex_event&) = delete;
+
+		///////////////////////////////
+
+	public:
+		/**
+		 * Wait until condition become true.
+		 * @param ready callable checking condition, it could also do
+		 * operation which condition is for, like taking element.
+		 * @param timeout_ms maximal waiting time in milliseconds,
+		 * negative to wait forever.
+		 * @return false if time passed and condition is still false.
+		 */
+		template<typename Condition>
+		bool wait(Condition ready, int timeout_ms = -1) {
+			for(int i = 0; i < SPIN_COUNT; i++){
+				if(ready()){
+					return true;
+				}
+				cpu_relax();
+			}
+
+			struct timespec deadline;
+			if(timeout_ms >= 0){
+				clock_gettime(CLOCK_MONOTONIC, &deadline);
+				add_ms(deadline, timeout_ms);
+			}
+			while(true){
+				// Counted before checking, so notify() sees sleeper
+				// or sleeper sees condition made true.
+				_sleepers++;
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				uint32_t epoch = _epoch.load();
+				if(ready()){
+					_sleepers--;
+					return true;
+				}
+				struct timespec left;
+				if(timeout_ms >= 0 && !time_left(deadline, left)){
+					_sleepers--;
+					return false;
+				}
+				syscall(SYS_futex, reinterpret_cast<int*>(&_epoch),
+						FUTEX_WAIT_PRIVATE, epoch,
+						timeout_ms >= 0 ? &left : NULL, NULL, 0);
+				_sleepers--;
+			}
+		}
+
+		/**
+		 * Wake sleeping threads. Called after condition is made true.
+		 */
+		void notify() noexcept {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(_sleepers.load(std::memory_order_relaxed)){
+				_epoch++;
+				syscall(SYS_futex, reinterpret_cast<int*>(&_epoch),
+						FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+			}
+		}
+
+		///////////////////////////////
+
+	protected:
+		static void add_ms(struct timespec& t, int ms) noexcept {
+			t.tv_sec += ms / 1000;
+			t.tv_nsec += (ms % 1000) * 1000000L;
+			if(t.tv_nsec >= 1000000000L){
+				t.tv_sec++;
+				t.tv_nsec -= 1000000000L;
+			}
+		}
+
+		/**
+		 * @return false if deadline passed.
+		 */
+		static bool time_left(const struct timespec& deadline,
+				struct timespec& left) noexcept {
+			struct timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			left.tv_sec = deadline.tv_sec - now.tv_sec;
+			left.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+			if(left.tv_nsec < 0){
+				left.tv_sec--;
+				left.tv_nsec += 1000000000L;
+			}
+			return left.tv_sec >= 0;
+		}
+
+		///////////////////////////////
+
+	protected:
+		/// Changed on every wake, futex word.
+		std::atomic<uint32_t> _epoch;
+		std::atomic<uint32_t> _sleepers;
+	};
+
+} // namespace stl_extensions
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // FUTEX_EVENT_H_
@@ -0,0 +1,168 @@
+/**
+ * @file gzip_streambuf.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Stream buffer writing gzip file, compressed on its own thread.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef GZIP_STREAMBUF_H_
+#define GZIP_STREAMBUF_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <streambuf>
+#include <ios>
+#include <vector>
+
+#include "thread.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace stl_extensions {
+
+	/**
+	 * @class gzip_streambuf
+	 * @brief Writes gzip file. Text is put to one buffer while thread
+	 * of file compresses other one and writes it out, and buffers
+	 * are swapped when put buffer is full, so writer waits only
+	 * when it is faster than compression.
+	 * sync() hands off text put so far and flushes compressor,
+	 * so everything before it could be decompressed, but it does not
+	 * wait until it is written. Appended file gets new gzip member,
+	 * which gzip tools read as continuation of file.
+	 */
+	class gzip_streambuf : public std::streambuf {
+	public:
+		/// Size of each buffer.
+		static const size_t BUFFER_SIZE = 1 << 20;
+
+		gzip_streambuf();
+		virtual ~gzip_streambuf();
+
+		gzip_streambuf(const gzip_streambuf&) = delete;
+		const gzip_streambuf& operator=(const gzip_streambuf&) = delete;
+
+		///////////////////////////////
+
+	public:
+		/**
+		 * Open file and start thread.
+		 * @param mode out, with app to append to file.
+		 * @return this or NULL if file could not be opened.
+		 */
+		gzip_streambuf* open(const char* name, std::ios_base::openmode mode);
+
+		/**
+		 * Finish gzip stream, wait until it is written and close file.
+		 * @return this or NULL on failure.
+		 */
+		gzip_streambuf* close();
+
+		bool is_open() const {
+			return _fd >= 0;
+		}
+
+		/**
+		 * @return errno of first failure or 0.
+		 */
+		int error() const noexcept {
+			return _error;
+		}
+
+		/**
+		 * @return number of bytes put to buffer.
+		 */
+		size_t bytes_in() const noexcept {
+			return _bytesIn;
+		}
+
+		/**
+		 * @return number of compressed bytes written to file.
+		 * Valid after close().
+		 */
+		size_t bytes_out() const noexcept {
+			return _bytesOut;
+		}
+
+		/**
+		 * @return seconds which thread spent compressing and writing.
+		 * Valid after close().
+		 */
+		double seconds() const noexcept {
+			return _seconds;
+		}
+
+		///////////////////////////////
+
+	protected:
+		virtual int sync();
+		virtual int_type overflow(int_type ch);
+
+		/**
+		 * Give put buffer to thread, after it is done with other one.
+		 * @param flush zlib flush mode of buffer.
+		 */
+		void handOff(int flush);
+
+		void run();
+
+		/**
+		 * Compress buffer and write it out.
+		 * @return errno of failure or 0.
+		 */
+		int compress(const char* data, size_t size, int flush);
+
+		class Call {
+		public:
+			explicit Call(gzip_streambuf* buffer)
+					: _buffer(buffer) {
+			}
+
+			void operator()() {
+				_buffer->run();
+			}
+
+		protected:
+			gzip_streambuf* _buffer;
+		};
+
+		///////////////////////////////
+
+	protected:
+		int _fd;
+		/// z_stream, used only by thread.
+		void* _stream;
+		std::vector<char> _out;
+		/// Buffer which text is put to, and one which thread compresses.
+		std::vector<char> _put;
+		std::vector<char> _back;
+		size_t _backSize;
+		int _backFlush;
+		/// Thread have back buffer.
+		bool _backBusy;
+		/// Nothing is put after last flush.
+		bool _synced;
+		bool _stop;
+		mutex _mutex;
+		condition_variable _changed;
+		thread* _thread;
+		int _error;
+		size_t _bytesIn;
+		size_t _bytesOut;
+		double _seconds;
+	};
+
+} // namespace stl_extensions
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // GZIP_STREAMBUF_H_
@@ -40,6 +40,18 @@ namespace stl_extensions {
 
 	public:
 		void open(const char* file_name);
+		/**
+		 * Map already opened file.
+		 * @param fd file descriptor, it is not closed.
+		 * @param file_name name of file for error messages.
+		 */
+		void open(int fd, const char* file_name);
+
+		/**
+		 * Tell kernel that mapping will be read from begin to end,
+		 * so it reads ahead more and drops pages behind sooner.
+		 */
+		void advise_sequential() const noexcept;
 
 		uint8_t* get_mapped_memory() const noexcept {
 			return _state->mapped_memory;
@@ -0,0 +1,261 @@
+/**
+ * @file mpmc_ring.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Lock-free bounded ring with many producers and many consumers.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef MPMC_RING_H_
+#define MPMC_RING_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <memory>
+#include <atomic>
+#include <utility>
+
+#include "futex_event.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace stl_extensions {
+
+	/**
+	 * @class mpmc_ring
+	 * @brief Bounded ring for any number of producers and consumers.
+	 * Every slot have sequence number telling if it is free or full
+	 * for current round over ring. Thread claims slots by moving
+	 * head or tail with compare and swap, and then fills or empties
+	 * them without any lock. Batch operations claim many slots
+	 * with one compare and swap.
+	 */
+	template <typename T>
+	class mpmc_ring {
+	public:
+		/**
+		 * @param capacity maximal number of elements,
+		 * rounded up to power of 2, and at least 2.
+		 */
+		explicit mpmc_ring(size_t capacity)
+				: _capacity(round_up(capacity)), _mask(_capacity - 1),
+				_slots(new slot[_capacity]), _head(0), _tail(0) {
+			for(size_t i = 0; i < _capacity; i++){
+				_slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		mpmc_ring(const mpmc_ring&) = delete;
+		const mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+		///////////////////////////////
+
+	public:
+		size_t capacity() const noexcept {
+			return _capacity;
+		}
+
+		/**
+		 * @return number of elements, could be old by the time it is used.
+		 */
+		size_t size() const noexcept {
+			size_t head = _head.load(std::memory_order_acquire);
+			size_t tail = _tail.load(std::memory_order_acquire);
+			return tail > head ? tail - head : 0;
+		}
+
+		///////////////////////////////
+
+		bool try_push(const T& value) {
+			return try_push_n(&value, 1) == 1;
+		}
+
+		/**
+		 * Push as many elements as there is free slots for, in order.
+		 * @return number of pushed elements.
+		 */
+		size_t try_push_n(const T* values, size_t n) {
+			size_t tail = _tail.load(std::memory_order_relaxed);
+			while(n){
+				// Count free slots from tail on.
+				size_t k = 0;
+				while(k < n && k < _capacity && _slots[(tail + k) & _mask]
+						.sequence.load(std::memory_order_acquire) == tail + k){
+					k++;
+				}
+				if(k == 0){
+					size_t seq = _slots[tail & _mask].sequence.load(
+							std::memory_order_acquire);
+					if(seq < tail + 1){
+						// Slot is not emptied from last round, ring is full.
+						return 0;
+					}
+					// Other producer took it.
+					tail = _tail.load(std::memory_order_relaxed);
+					continue;
+				}
+				if(_tail.compare_exchange_weak(tail, tail + k,
+						std::memory_order_relaxed)){
+					for(size_t i = 0; i < k; i++){
+						slot& s = _slots[(tail + i) & _mask];
+						s.value = values[i];
+						s.sequence.store(tail + i + 1,
+								std::memory_order_release);
+					}
+					_not_empty.notify();
+					return k;
+				}
+			}
+			return 0;
+		}
+
+		/**
+		 * Push, waiting while ring is full.
+		 */
+		void push(const T& value) {
+			_not_full.wait([&]() { return try_push(value); });
+		}
+
+		/**
+		 * Push all elements, waiting while ring is full.
+		 * Elements of other producers could come between them.
+		 */
+		void push_n(const T* values, size_t n) {
+			while(n){
+				size_t pushed = 0;
+				_not_full.wait([&]() {
+					pushed = try_push_n(values, n);
+					return pushed != 0;
+				});
+				values += pushed;
+				n -= pushed;
+			}
+		}
+
+		///////////////////////////////
+
+		bool try_pop(T& value) {
+			return try_pop_n(&value, 1) == 1;
+		}
+
+		/**
+		 * Pop as many elements as there is, up to n, in order.
+		 * @return number of popped elements.
+		 */
+		size_t try_pop_n(T* values, size_t n) {
+			size_t head = _head.load(std::memory_order_relaxed);
+			while(n){
+				// Count full slots from head on.
+				size_t k = 0;
+				while(k < n && k < _capacity && _slots[(head + k) & _mask]
+						.sequence.load(std::memory_order_acquire)
+						== head + k + 1){
+					k++;
+				}
+				if(k == 0){
+					size_t seq = _slots[head & _mask].sequence.load(
+							std::memory_order_acquire);
+					if(seq < head + 1){
+						// Slot is not filled yet, ring is empty.
+						return 0;
+					}
+					// Other consumer took it.
+					head = _head.load(std::memory_order_relaxed);
+					continue;
+				}
+				if(_head.compare_exchange_weak(head, head + k,
+						std::memory_order_relaxed)){
+					for(size_t i = 0; i < k; i++){
+						slot& s = _slots[(head + i) & _mask];
+						values[i] = std::move(s.value);
+						// Do not keep resources of element alive in ring.
+						s.value = T();
+						s.sequence.store(head + i + _capacity,
+								std::memory_order_release);
+					}
+					_not_full.notify();
+					return k;
+				}
+			}
+			return 0;
+		}
+
+		/**
+		 * Pop, waiting while ring is empty.
+		 */
+		void pop(T& value) {
+			_not_empty.wait([&]() { return try_pop(value); });
+		}
+
+		/**
+		 * Pop, waiting at most given time.
+		 * @return false if ring is still empty.
+		 */
+		bool pop_for(T& value, int timeout_ms) {
+			return _not_empty.wait([&]() { return try_pop(value); },
+					timeout_ms);
+		}
+
+		/**
+		 * Pop at least one element and up to n, waiting while ring
+		 * is empty.
+		 * @return number of popped elements.
+		 */
+		size_t pop_n(T* values, size_t n) {
+			size_t popped = 0;
+			_not_empty.wait([&]() {
+				popped = try_pop_n(values, n);
+				return popped != 0;
+			});
+			return popped;
+		}
+
+		///////////////////////////////
+
+	protected:
+		class slot {
+		public:
+			/// Equal to position for free slot and position + 1 for full one.
+			std::atomic<size_t> sequence;
+			T value;
+		};
+
+		static size_t round_up(size_t capacity) {
+			// In ring of 1 slot, full slot has sequence of next free one.
+			size_t size = 2;
+			while(size < capacity){
+				size *= 2;
+			}
+			return size;
+		}
+
+		///////////////////////////////
+
+	protected:
+		size_t _capacity;
+		size_t _mask;
+		std::unique_ptr<slot[]> _slots;
+		// Padding keeps consumer and producer indexes
+		// on separate cache lines.
+		char _padding0[64];
+		std::atomic<size_t> _head;
+		char _padding1[64];
+		std::atomic<size_t> _tail;
+		char _padding2[64];
+		futex_event _not_empty;
+		futex_event _not_full;
+	};
+
+} // namespace stl_extensions
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // MPMC_RING_H_
@@ -0,0 +1,220 @@
+/**
+ * @file spsc_ring.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Lock-free bounded ring with one producer and one consumer.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <utility>
+
+#include "futex_event.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace stl_extensions {
+
+	/**
+	 * @class spsc_ring
+	 * @brief Bounded ring for exactly one producer thread and one
+	 * consumer thread. Producer only writes tail and consumer only
+	 * writes head, so no atomic read-modify-write is needed.
+	 * Each side keeps last seen index of other side on its own cache
+	 * line and reads real one only when ring looks full or empty.
+	 */
+	template <typename T>
+	class spsc_ring {
+	public:
+		/**
+		 * @param capacity maximal number of elements,
+		 * rounded up to power of 2.
+		 */
+		explicit spsc_ring(size_t capacity)
+				: _slots(round_up(capacity)), _mask(_slots.size() - 1),
+				_head(0), _cached_tail(0), _tail(0), _cached_head(0) {
+		}
+
+		spsc_ring(const spsc_ring&) = delete;
+		const spsc_ring& operator=(const spsc_ring&) = delete;
+
+		///////////////////////////////
+
+	public:
+		size_t capacity() const noexcept {
+			return _slots.size();
+		}
+
+		/**
+		 * @return number of elements, could be old by the time it is used.
+		 */
+		size_t size() const noexcept {
+			return _tail.load(std::memory_order_acquire)
+					- _head.load(std::memory_order_acquire);
+		}
+
+		///////////////////////////////
+		// Producer side.
+
+		bool try_push(const T& value) {
+			return try_push_n(&value, 1) == 1;
+		}
+
+		/**
+		 * Push as many elements as there is place for.
+		 * @return number of pushed elements.
+		 */
+		size_t try_push_n(const T* values, size_t n) {
+			size_t tail = _tail.load(std::memory_order_relaxed);
+			size_t free = _slots.size() - (tail - _cached_head);
+			if(free < n){
+				_cached_head = _head.load(std::memory_order_acquire);
+				free = _slots.size() - (tail - _cached_head);
+			}
+			if(n > free){
+				n = free;
+			}
+			for(size_t i = 0; i < n; i++){
+				_slots[(tail + i) & _mask] = values[i];
+			}
+			if(n){
+				_tail.store(tail + n, std::memory_order_release);
+				_not_empty.notify();
+			}
+			return n;
+		}
+
+		/**
+		 * Push, waiting while ring is full.
+		 */
+		void push(const T& value) {
+			_not_full.wait([&]() { return try_push(value); });
+		}
+
+		/**
+		 * Push all elements, waiting while ring is full.
+		 */
+		void push_n(const T* values, size_t n) {
+			while(n){
+				size_t pushed = 0;
+				_not_full.wait([&]() {
+					pushed = try_push_n(values, n);
+					return pushed != 0;
+				});
+				values += pushed;
+				n -= pushed;
+			}
+		}
+
+		///////////////////////////////
+		// Consumer side.
+
+		bool try_pop(T& value) {
+			return try_pop_n(&value, 1) == 1;
+		}
+
+		/**
+		 * Pop as many elements as there is, up to n.
+		 * @return number of popped elements.
+		 */
+		size_t try_pop_n(T* values, size_t n) {
+			size_t head = _head.load(std::memory_order_relaxed);
+			size_t full = _cached_tail - head;
+			if(full < n){
+				_cached_tail = _tail.load(std::memory_order_acquire);
+				full = _cached_tail - head;
+			}
+			if(n > full){
+				n = full;
+			}
+			for(size_t i = 0; i < n; i++){
+				T& slot = _slots[(head + i) & _mask];
+				values[i] = std::move(slot);
+				// Do not keep resources of element alive in ring.
+				slot = T();
+			}
+			if(n){
+				_head.store(head + n, std::memory_order_release);
+				_not_full.notify();
+			}
+			return n;
+		}
+
+		/**
+		 * Pop, waiting while ring is empty.
+		 */
+		void pop(T& value) {
+			_not_empty.wait([&]() { return try_pop(value); });
+		}
+
+		/**
+		 * Pop, waiting at most given time.
+		 * @return false if ring is still empty.
+		 */
+		bool pop_for(T& value, int timeout_ms) {
+			return _not_empty.wait([&]() { return try_pop(value); },
+					timeout_ms);
+		}
+
+		/**
+		 * Pop at least one element and up to n, waiting while ring
+		 * is empty.
+		 * @return number of popped elements.
+		 */
+		size_t pop_n(T* values, size_t n) {
+			size_t popped = 0;
+			_not_empty.wait([&]() {
+				popped = try_pop_n(values, n);
+				return popped != 0;
+			});
+			return popped;
+		}
+
+		///////////////////////////////
+
+	protected:
+		static size_t round_up(size_t capacity) {
+			size_t size = 1;
+			while(size < capacity){
+				size *= 2;
+			}
+			return size;
+		}
+
+		///////////////////////////////
+
+	protected:
+		std::vector<T> _slots;
+		size_t _mask;
+		// Padding keeps consumer and producer indexes
+		// on separate cache lines.
+		char _padding0[64];
+		std::atomic<size_t> _head;
+		size_t _cached_tail;
+		char _padding1[64];
+		std::atomic<size_t> _tail;
+		size_t _cached_head;
+		char _padding2[64];
+		futex_event _not_empty;
+		futex_event _not_full;
+	};
+
+} // namespace stl_extensions
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // SPSC_RING_H_
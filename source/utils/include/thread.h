@@ -275,6 +275,8 @@ static inline void sleepMs(uint ms){
 #endif
 
 #include <semaphore.h>
+#include <ctime>
+#include <cerrno>
 
 class semaphore {
 private:
@@ -305,8 +307,11 @@ public:
 	}
 
 	void wait() {
-		if(sem_wait(&_semapore)){
-			__THROW_CONCURENT_ERROR();
+		// Signal handler could interrupt waiting.
+		while(sem_wait(&_semapore)){
+			if(errno != EINTR){
+				__THROW_CONCURENT_ERROR();
+			}
 		}
 	}
 
@@ -320,10 +325,42 @@ public:
 		return *this;
 	}
 
-	void tryWait() {
-		if(sem_trywait(&_semapore)){
-			__THROW_CONCURENT_ERROR();
+	/**
+	 * @return false if semaphore is zero and could not be decremented.
+	 */
+	bool tryWait() {
+		while(sem_trywait(&_semapore)){
+			if(errno == EAGAIN){
+				return false;
+			}else if(errno != EINTR){
+				__THROW_CONCURENT_ERROR();
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Wait at most given time.
+	 * @param ms time to wait in milliseconds.
+	 * @return false if time passed and semaphore is still zero.
+	 */
+	bool timedWait(int ms) {
+		struct timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_sec += ms / 1000;
+		ts.tv_nsec += (ms % 1000) * 1000000L;
+		if(ts.tv_nsec >= 1000000000L){
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000L;
+		}
+		while(sem_timedwait(&_semapore, &ts)){
+			if(errno == ETIMEDOUT){
+				return false;
+			}else if(errno != EINTR){
+				__THROW_CONCURENT_ERROR();
+			}
 		}
+		return true;
 	}
 
 	int getValue() {
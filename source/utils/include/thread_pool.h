@@ -0,0 +1,214 @@
+/**
+ * @file thread_pool.h
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Pool of threads running small tasks, with work stealing.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+#include "CommonMacros.h"
+#include "thread.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class thread_pool
+ * @brief Fixed number of worker threads running tasks.
+ * Every worker have its own deque of tasks. Task submitted from worker
+ * goes to back of its deque and worker takes tasks from back, so it
+ * runs newest task, which data is still in cache. Idle worker steals
+ * oldest task from front of other deque, which is usually biggest
+ * piece of work left. Tasks submitted from other threads are spread
+ * over workers in turn. Worker without any task sleeps.
+ */
+class thread_pool {
+public:
+	typedef std::function<void()> task;
+
+	/**
+	 * @param threads number of workers, 0 for number of CPUs.
+	 * @param pin_threads pin every worker to one CPU.
+	 */
+	explicit thread_pool(size_t threads = 0, bool pin_threads = false);
+
+	/**
+	 * Run all submitted tasks and stop workers.
+	 */
+	~thread_pool();
+
+	thread_pool(const thread_pool&) = delete;
+	const thread_pool& operator=(const thread_pool&) = delete;
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Put task to be run on some worker.
+	 */
+	void submit(const task& t);
+
+	/**
+	 * Run one waiting task on calling thread, so thread waiting
+	 * for tasks helps instead of blocking.
+	 * @return false if no task was waiting.
+	 */
+	bool run_pending();
+
+	size_t size() const noexcept {
+		return _workers.size();
+	}
+
+	/**
+	 * @return number of online CPUs.
+	 */
+	static size_t cpu_count();
+
+	///////////////////////////////////
+
+protected:
+	class worker {
+	public:
+		worker()
+				: t(0) {
+		}
+
+		mutex lock;
+		std::deque<task> tasks;
+		thread* t;
+	};
+
+	/**
+	 * @class worker_call
+	 * @brief Callable for worker thread.
+	 */
+	class worker_call {
+	public:
+		worker_call(thread_pool* pool, size_t index)
+				: _pool(pool), _index(index) {
+		}
+
+		void operator()() {
+			_pool->work(_index);
+		}
+
+	protected:
+		thread_pool* _pool;
+		size_t _index;
+	};
+
+	void work(size_t index);
+
+	/**
+	 * Take newest task of worker.
+	 */
+	bool pop(size_t index, task& t);
+
+	/**
+	 * Take oldest task of some other worker.
+	 * @param thief index of worker which steals, or size() for
+	 * thread which is not worker.
+	 */
+	bool steal(size_t thief, task& t);
+
+	/**
+	 * @return index of calling worker in this pool or size().
+	 */
+	size_t current() const noexcept;
+
+	friend class task_group;
+
+	/**
+	 * Sleep while group have running tasks and no task is waiting.
+	 */
+	void block(const std::atomic<size_t>& running);
+
+	/**
+	 * Wake threads blocked in block(), after last task of some group.
+	 */
+	void wake_blocked();
+
+	///////////////////////////////////
+
+protected:
+	std::vector<worker*> _workers;
+	bool _pin_threads;
+	/// Next worker for task from outside of pool.
+	std::atomic<size_t> _next;
+	/// Tasks in all deques.
+	std::atomic<size_t> _pending;
+	/// Sleeping workers and blocked waiters of groups.
+	std::atomic<size_t> _sleeping;
+	std::atomic<bool> _stop;
+	mutex _sleep_mutex;
+	condition_variable _wake;
+};
+
+///////////////////////////////////////
+
+/**
+ * @class task_group
+ * @brief Tasks which could be waited for together.
+ * Waiting thread runs tasks of pool meanwhile, so task could also
+ * make group and wait for it without blocking its worker. When there
+ * is no task to run, waiting thread sleeps until last task of group
+ * is done or new task is submitted.
+ */
+class task_group {
+public:
+	explicit task_group(thread_pool& pool)
+			: _pool(pool), _running(0) {
+	}
+
+	/**
+	 * Wait for all tasks of group.
+	 */
+	~task_group();
+
+	task_group(const task_group&) = delete;
+	const task_group& operator=(const task_group&) = delete;
+
+	///////////////////////////////////
+
+public:
+	/**
+	 * Run task on pool as part of group.
+	 */
+	void run(const thread_pool::task& t);
+
+	/**
+	 * Wait until all tasks of group are done.
+	 * Rethrows first exception thrown from some task.
+	 */
+	void wait();
+
+	///////////////////////////////////
+
+protected:
+	thread_pool& _pool;
+	std::atomic<size_t> _running;
+	mutex _error_mutex;
+	std::exception_ptr _error;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // THREAD_POOL_H_
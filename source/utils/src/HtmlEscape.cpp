@@ -28,202 +28,527 @@
 #include "HtmlEscape.h"
 
 #include <string>
-#include <cstdio>
+#include <cstring>
 
-#include <iostream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace HtmlEscape{
 
+    Table::Table(bool tags, bool br, bool special, bool utf8)
+            : _buckets(0), _utf8(utf8) {
+        memset(_replacement, 0, sizeof(_replacement));
+        memset(_replacementSize, 0, sizeof(_replacementSize));
+        memset(_lo, 0, sizeof(_lo));
+        memset(_hi, 0, sizeof(_hi));
+
+        if(tags){
+            set('<', "&lt;");
+            set('>', "&gt;");
+            set('"', "&quot;");
+        }
+        if(br){
+            set('\n', "<br/>");
+            set('\r', "");
+        }
+        if(special){
+            set('&', "&amp;");
+        }
+        if(utf8){
+            set('\0', REPLACEMENT_CHARACTER);
+        }
+        selectFind();
+    }
 
-#define ESCAPE_TAGS case '<':out.append("&lt;"); break; \
-            case '>':out.append("&gt;"); break; \
-            case '"':out.append("&quot;"); break;
-
-#define ESCAPE_BR case '\n': out.append("<br/>"); break; \
-            case '\r': break;
-
-#define ESCAPE_SPECIAL case 38:out.append("&amp;"); break; \
-			case 198:out.append("&AElig;"); break; \
-			case 193:out.append("&Aacute;"); break; \
-			case 194:out.append("&Acirc;"); break; \
-			case 192:out.append("&Agrave;"); break; \
-			case 197:out.append("&Aring;"); break; \
-			case 195:out.append("&Atilde;"); break; \
-			case 196:out.append("&Auml;"); break; \
-			case 199:out.append("&Ccedil;"); break; \
-			case 208:out.append("&ETH;"); break; \
-			case 201:out.append("&Eacute;"); break; \
-			case 202:out.append("&Ecirc;"); break; \
-			case 200:out.append("&Egrave;"); break; \
-			case 203:out.append("&Euml;"); break; \
-			case 205:out.append("&Iacute;"); break; \
-			case 206:out.append("&Icirc;"); break; \
-			case 204:out.append("&Igrave;"); break; \
-			case 207:out.append("&Iuml;"); break; \
-			case 209:out.append("&Ntilde;"); break; \
-			case 211:out.append("&Oacute;"); break; \
-			case 212:out.append("&Ocirc;"); break; \
-			case 210:out.append("&Ograve;"); break; \
-			case 216:out.append("&Oslash;"); break; \
-			case 213:out.append("&Otilde;"); break; \
-			case 214:out.append("&Ouml;"); break; \
-			case 222:out.append("&THORN;"); break; \
-			case 218:out.append("&Uacute;"); break; \
-			case 219:out.append("&Ucirc;"); break; \
-			case 217:out.append("&Ugrave;"); break; \
-			case 220:out.append("&Uuml;"); break; \
-			case 221:out.append("&Yacute;"); break; \
-			case 225:out.append("&aacute;"); break; \
-			case 226:out.append("&acirc;"); break; \
-			case 230:out.append("&aelig;"); break; \
-			case 224:out.append("&agrave;"); break; \
-			case 229:out.append("&aring;"); break; \
-			case 227:out.append("&atilde;"); break; \
-			case 228:out.append("&auml;"); break; \
-			case 231:out.append("&ccedil;"); break; \
-			case 233:out.append("&eacute;"); break; \
-			case 234:out.append("&ecirc;"); break; \
-			case 232:out.append("&egrave;"); break; \
-			case 240:out.append("&eth;"); break; \
-			case 235:out.append("&euml;"); break; \
-			case 237:out.append("&iacute;"); break; \
-			case 238:out.append("&icirc;"); break; \
-			case 236:out.append("&igrave;"); break; \
-			case 239:out.append("&iuml;"); break; \
-			case 241:out.append("&ntilde;"); break; \
-			case 243:out.append("&oacute;"); break; \
-			case 244:out.append("&ocirc;"); break; \
-			case 242:out.append("&ograve;"); break; \
-			case 248:out.append("&oslash;"); break; \
-			case 245:out.append("&otilde;"); break; \
-			case 246:out.append("&ouml;"); break; \
-			case 223:out.append("&szlig;"); break; \
-			case 254:out.append("&thorn;"); break; \
-			case 250:out.append("&uacute;"); break; \
-			case 251:out.append("&ucirc;"); break; \
-			case 249:out.append("&ugrave;"); break; \
-			case 252:out.append("&uuml;"); break; \
-			case 253:out.append("&yacute;"); break; \
-			case 255:out.append("&yuml;"); break; \
-			case 162:out.append("&cent;"); break; \
+    Table Table::javascript(){
+        static const char* const controls[32] = {
+            "", "\\u0001", "\\u0002", "\\u0003",
+            "\\u0004", "\\u0005", "\\u0006", "\\u0007",
+            "\\b", "\\t", "\\n", "\\u000b",
+            "\\f", "\\r", "\\u000e", "\\u000f",
+            "\\u0010", "\\u0011", "\\u0012", "\\u0013",
+            "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+            "\\u0018", "\\u0019", "\\u001a", "\\u001b",
+            "\\u001c", "\\u001d", "\\u001e", "\\u001f"
+        };
+        Table t(false, false, false, true);
+        t.set('"', "\\\"");
+        t.set('\\', "\\\\");
+        // NUL keeps replacement character. Other control characters
+        // share one bucket, which matches high nibble 0 and 1 exactly.
+        for(int c = 1; c < 32; c++){
+            t._replacement[c] = controls[c];
+            t._replacementSize[c] = strlen(controls[c]);
+        }
+        if(t._buckets < 8){
+            uint8_t bucket = 1 << t._buckets;
+            for(int i = 0; i < 16; i++){
+                t._lo[i] |= bucket;
+            }
+            t._hi[0] |= bucket;
+            t._hi[1] |= bucket;
+        }
+        t._buckets++;
+        t.selectFind();
+        return t;
+    }
 
+    void Table::selectFind(){
+        _find = findScalar;
+        _valid = validScalar;
+        _implementation = "scalar";
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")){
+            _valid = validAvx2;
+            _implementation = "avx2";
+        }else if(__builtin_cpu_supports("ssse3")){
+            _valid = validSsse3;
+            _implementation = "ssse3";
+        }
+        // Every replaced byte, or range of control characters,
+        // have its own bucket bit, so SIMD hits need no checking.
+        if(_buckets <= 8){
+            _find = _valid == validAvx2 ? findAvx2
+                    : _valid == validSsse3 ? findSsse3 : findScalar;
+        }
+#endif
+    }
 
+    void Table::set(uint8_t c, const char* replacement){
+        _replacement[c] = replacement;
+        _replacementSize[c] = strlen(replacement);
+        if(_buckets < 8){
+            uint8_t bucket = 1 << _buckets;
+            _lo[c & 0xf] |= bucket;
+            _hi[c >> 4] |= bucket;
+        }
+        _buckets++;
+    }
+
+    size_t Table::findScalar(const Table& t, const uint8_t* s, size_t n){
+        size_t i = 0;
+        while(i < n && !t._replacement[s[i]]){
+            i++;
+        }
+        return i;
+    }
 
     /**
-     * Function for HTML escaping a string, for use in a textarea.
-     * @param original The String to escape
-     * @return The escaped String
+     * Check one UTF-8 sequence starting with non ASCII byte.
+     * @param invalid set to length of invalid part if sequence is invalid.
+     * @return length of valid sequence, or 0.
      */
-    std::string escapeTextArea(std::string original){
-        using namespace std;
-
-        string out;
-
-        string::iterator iter = original.begin(), end = original.end();
-        for(; iter != end ; iter++){
-			int c = *iter;
-            switch( c ){
-            ESCAPE_TAGS
-            ESCAPE_SPECIAL
-            default:
-                if( c > 127 ){
-                    char x[9];
-                    sprintf(x, "&#x%4x;", c);
-                }else
-                  out.append(1, *iter);
+    static size_t utf8Sequence(const uint8_t* s, size_t n, size_t& invalid){
+        uint8_t c = s[0];
+        size_t size;
+        // Range of second byte, which excludes overlong forms,
+        // surrogates and code points above U+10FFFF.
+        uint8_t lo = 0x80;
+        uint8_t hi = 0xbf;
+        if(c >= 0xc2 && c <= 0xdf){
+            size = 2;
+        }else if(c >= 0xe0 && c <= 0xef){
+            size = 3;
+            if(c == 0xe0){
+                lo = 0xa0;
+            }else if(c == 0xed){
+                hi = 0x9f;
+            }
+        }else if(c >= 0xf0 && c <= 0xf4){
+            size = 4;
+            if(c == 0xf0){
+                lo = 0x90;
+            }else if(c == 0xf4){
+                hi = 0x8f;
+            }
+        }else{
+            invalid = 1;
+            return 0;
+        }
+        size_t i = 1;
+        for(; i < size && i < n; i++){
+            if(s[i] < lo || s[i] > hi){
                 break;
             }
+            lo = 0x80;
+            hi = 0xbf;
+        }
+        if(i == size){
+            return size;
         }
+        invalid = i;
+        return 0;
+    }
 
-        return out;
+    size_t invalidUtf8(const char* s, size_t n){
+        size_t invalid = 1;
+        utf8Sequence(reinterpret_cast<const uint8_t*>(s), n, invalid);
+        return invalid;
     }
 
-    /**
-     * Normal escape function, for Html escaping Strings
-     * @param original The original String
-     * @return The escape String
-     */
-    std::string escape(std::string original){
-        using namespace std;
-
-        string out;
-
-        string::iterator iter = original.begin(), end = original.end();
-        for(; iter != end ; iter++){
-			int c = *iter;
-            switch( c ){
-            ESCAPE_TAGS
-            ESCAPE_BR
-            ESCAPE_SPECIAL
-            default:
-                if( c > 127 ){
-                    char x[9];
-                    sprintf(x, "&#x%4x;", c);
-                }else
-                  out.append(1, *iter);
+    size_t Table::validScalar(const uint8_t* s, size_t n){
+        size_t i = 0;
+        while(i < n){
+            // Skip ASCII by words.
+            uint64_t word;
+            while(i + 8 <= n){
+                memcpy(&word, s + i, 8);
+                if(word & 0x8080808080808080ULL){
+                    break;
+                }
+                i += 8;
+            }
+            if(i == n){
                 break;
             }
+            if(s[i] < 0x80){
+                i++;
+                continue;
+            }
+            size_t invalid;
+            size_t size = utf8Sequence(s + i, n - i, invalid);
+            if(!size){
+                break;
+            }
+            i += size;
         }
+        return i;
+    }
 
-        return out;
+    /**
+     * Sequence could start up to 3 bytes before end of blocks checked
+     * with SIMD. Return position of first sequence which is not checked
+     * as whole, so scalar code could continue from there.
+     */
+    static size_t sequenceStart(const uint8_t* s, size_t i){
+        size_t j = i < 3 ? 0 : i - 3;
+        while(j < i && (s[j] & 0xc0) == 0x80){
+            j++;
+        }
+        return j;
     }
 
-    std::string escapeTags(std::string original){
-        using namespace std;
+#if defined(__x86_64__) || defined(__i386__)
 
-        string out;
+    /*
+     * SIMD UTF-8 validation by John Keiser and Daniel Lemire,
+     * "Validating UTF-8 In Less Than One Instruction Per Byte".
+     * Error classes are looked up by nibbles of every byte and of
+     * byte before it, and AND of three lookups is non zero for any
+     * error in two byte window. Third and fourth bytes of sequence
+     * are checked to be continuations separately.
+     */
 
-        string::iterator iter = original.begin(), end = original.end();
-        for(; iter != end ; iter++){
-			int c = *iter;
-            switch( c ){
-            ESCAPE_TAGS
-            default:out.append(1, c); break;
-            }
-        }
+    static const uint8_t TOO_SHORT = 1 << 0;
+    static const uint8_t TOO_LONG = 1 << 1;
+    static const uint8_t OVERLONG_3 = 1 << 2;
+    static const uint8_t TOO_LARGE = 1 << 3;
+    static const uint8_t SURROGATE = 1 << 4;
+    static const uint8_t OVERLONG_2 = 1 << 5;
+    static const uint8_t TOO_LARGE_1000 = 1 << 6;
+    static const uint8_t OVERLONG_4 = 1 << 6;
+    static const uint8_t TWO_CONTS = 1 << 7;
+    static const uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    alignas(16) static const uint8_t byte1High[16] = {
+        // ASCII.
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        // Continuation.
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        // 110_____
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        // 1110____
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        // 1111____
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+    };
+
+    alignas(16) static const uint8_t byte1Low[16] = {
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        CARRY | OVERLONG_2,
+        CARRY,
+        CARRY,
+        CARRY | TOO_LARGE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000
+    };
+
+    alignas(16) static const uint8_t byte2High[16] = {
+        // ASCII.
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        // 1000____
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000
+                | OVERLONG_4,
+        // 1001____
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        // 101_____
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        // Lead byte.
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+    };
 
-        return out;
+    /**
+     * @return non zero bytes where block has error, including
+     * sequences started in previous block.
+     */
+    __attribute__((target("ssse3"))) static inline
+    __m128i utf8Errors16(__m128i input, __m128i prev){
+        const __m128i nibble = _mm_set1_epi8(0xf);
+        __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+        __m128i special = _mm_and_si128(_mm_and_si128(
+                _mm_shuffle_epi8(_mm_load_si128((const __m128i*)byte1High),
+                        _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                _mm_shuffle_epi8(_mm_load_si128((const __m128i*)byte1Low),
+                        _mm_and_si128(prev1, nibble))),
+                _mm_shuffle_epi8(_mm_load_si128((const __m128i*)byte2High),
+                        _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+        __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 14),
+                _mm_set1_epi8(0xe0 - 0x80));
+        __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 13),
+                _mm_set1_epi8(0xf0 - 0x80));
+        __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth),
+                _mm_set1_epi8(0x80));
+        return _mm_xor_si128(must23, special);
     }
 
-    std::string escapeBr(std::string original){
-        using namespace std;
+    __attribute__((target("avx2"))) static inline
+    __m256i utf8Errors32(__m256i input, __m256i prev){
+        const __m256i nibble = _mm256_set1_epi8(0xf);
+        // Input shifted by one block, for byte before each byte.
+        __m256i shifted = _mm256_permute2x128_si256(prev, input, 0x21);
+        __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+        __m256i special = _mm256_and_si256(_mm256_and_si256(
+                _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+                        _mm_load_si128((const __m128i*)byte1High)),
+                        _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+                        _mm_load_si128((const __m128i*)byte1Low)),
+                        _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+                        _mm_load_si128((const __m128i*)byte2High)),
+                        _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+        __m256i third = _mm256_subs_epu8(_mm256_alignr_epi8(input, shifted, 14),
+                _mm256_set1_epi8(0xe0 - 0x80));
+        __m256i fourth = _mm256_subs_epu8(_mm256_alignr_epi8(input, shifted, 13),
+                _mm256_set1_epi8(0xf0 - 0x80));
+        __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                _mm256_set1_epi8(0x80));
+        return _mm256_xor_si256(must23, special);
+    }
 
-        string out;
+    /*
+     * Both versions check text in blocks, and last part of text is
+     * copied to block padded with zeros. Zeros are ASCII, so sequence
+     * cut by end of text is found as error. Block of ASCII after block
+     * of ASCII cannot have error, so it is only skipped. On error, scalar
+     * code finds exact place, starting from last sequence which is not
+     * checked as whole.
+     */
 
-        string::iterator iter = original.begin(), end = original.end();
-        for(; iter != end ; iter++){
-			int c = *iter;
-            switch( c ){
-            ESCAPE_BR
-            default:out.append(1, c); break;
+    __attribute__((target("ssse3")))
+    size_t Table::validSsse3(const uint8_t* s, size_t n){
+        __m128i prev = _mm_setzero_si128();
+        size_t i = 0;
+        for(; i < n; i += 16){
+            __m128i input;
+            if(i + 16 <= n){
+                input = _mm_loadu_si128((const __m128i*)(s + i));
+            }else{
+                alignas(16) uint8_t tail[16] = {};
+                memcpy(tail, s + i, n - i);
+                input = _mm_load_si128((const __m128i*)tail);
+            }
+            if(_mm_movemask_epi8(input) || _mm_movemask_epi8(prev)){
+                __m128i errors = utf8Errors16(input, prev);
+                if(_mm_movemask_epi8(_mm_cmpeq_epi8(errors,
+                        _mm_setzero_si128())) != 0xffff){
+                    break;
+                }
             }
+            prev = input;
         }
+        if(i >= n){
+            // Text ending on block end could still end with cut sequence.
+            __m128i errors = utf8Errors16(_mm_setzero_si128(), prev);
+            if(_mm_movemask_epi8(_mm_cmpeq_epi8(errors,
+                    _mm_setzero_si128())) == 0xffff){
+                return n;
+            }
+            i = n;
+        }
+        size_t j = sequenceStart(s, i);
+        return j + validScalar(s + j, n - j);
+    }
 
-        return out;
+    __attribute__((target("avx2")))
+    size_t Table::validAvx2(const uint8_t* s, size_t n){
+        __m256i prev = _mm256_setzero_si256();
+        size_t i = 0;
+        for(; i < n; i += 32){
+            __m256i input;
+            if(i + 32 <= n){
+                input = _mm256_loadu_si256((const __m256i*)(s + i));
+            }else{
+                alignas(32) uint8_t tail[32] = {};
+                memcpy(tail, s + i, n - i);
+                input = _mm256_load_si256((const __m256i*)tail);
+            }
+            if(_mm256_movemask_epi8(input) || _mm256_movemask_epi8(prev)){
+                __m256i errors = utf8Errors32(input, prev);
+                if(!_mm256_testz_si256(errors, errors)){
+                    break;
+                }
+            }
+            prev = input;
+        }
+        if(i >= n){
+            // Text ending on block end could still end with cut sequence.
+            __m256i errors = utf8Errors32(_mm256_setzero_si256(), prev);
+            if(_mm256_testz_si256(errors, errors)){
+                return n;
+            }
+            i = n;
+        }
+        size_t j = sequenceStart(s, i);
+        return j + validScalar(s + j, n - j);
     }
 
-    std::string escapeSpecial(std::string original){
-        using namespace std;
+    /**
+     * @return bit mask of replaced bytes in 16 bytes from s.
+     */
+    __attribute__((target("ssse3"))) static inline
+    uint32_t hits16(__m128i lo, __m128i hi, const uint8_t* s){
+        const __m128i nibble = _mm_set1_epi8(0xf);
+        __m128i v = _mm_loadu_si128((const __m128i*)s);
+        __m128i m = _mm_and_si128(
+                _mm_shuffle_epi8(lo, _mm_and_si128(v, nibble)),
+                _mm_shuffle_epi8(hi,
+                        _mm_and_si128(_mm_srli_epi16(v, 4), nibble)));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(m, _mm_setzero_si128()))
+                ^ 0xffff;
+    }
 
-        string out;
+    __attribute__((target("ssse3")))
+    size_t Table::findSsse3(const Table& t, const uint8_t* s, size_t n){
+        __m128i lo = _mm_load_si128((const __m128i*)t._lo);
+        __m128i hi = _mm_load_si128((const __m128i*)t._hi);
+        size_t i = 0;
+        for(; i + 16 <= n; i += 16){
+            uint32_t hits = hits16(lo, hi, s + i);
+            if(hits){
+                return i + __builtin_ctz(hits);
+            }
+        }
+        return i + findScalar(t, s + i, n - i);
+    }
 
-        string::iterator iter = original.begin(), end = original.end();
-        for(; iter != end ; iter++){
-			int c = *iter;
-            switch( c ){
-            ESCAPE_SPECIAL
-            default:
-                if( c > 127 ){
-                    char x[9];
-                    sprintf(x, "&#x%4x;", c);
-                }else
-                  out.append(1, c);
-                break;
+    __attribute__((target("avx2")))
+    size_t Table::findAvx2(const Table& t, const uint8_t* s, size_t n){
+        __m128i lo = _mm_load_si128((const __m128i*)t._lo);
+        __m128i hi = _mm_load_si128((const __m128i*)t._hi);
+        const __m256i nibble = _mm256_set1_epi8(0xf);
+        __m256i lo2 = _mm256_broadcastsi128_si256(lo);
+        __m256i hi2 = _mm256_broadcastsi128_si256(hi);
+        size_t i = 0;
+        for(; i + 32 <= n; i += 32){
+            __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+            __m256i m = _mm256_and_si256(
+                    _mm256_shuffle_epi8(lo2, _mm256_and_si256(v, nibble)),
+                    _mm256_shuffle_epi8(hi2, _mm256_and_si256(
+                            _mm256_srli_epi16(v, 4), nibble)));
+            uint32_t hits = ~uint32_t(_mm256_movemask_epi8(
+                    _mm256_cmpeq_epi8(m, _mm256_setzero_si256())));
+            if(hits){
+                return i + __builtin_ctz(hits);
+            }
+        }
+        if(i + 16 <= n){
+            uint32_t hits = hits16(lo, hi, s + i);
+            if(hits){
+                return i + __builtin_ctz(hits);
             }
+            i += 16;
         }
+        return i + findScalar(t, s + i, n - i);
+    }
+
+#else
+
+    size_t Table::findSsse3(const Table& t, const uint8_t* s, size_t n){
+        return findScalar(t, s, n);
+    }
+
+    size_t Table::findAvx2(const Table& t, const uint8_t* s, size_t n){
+        return findScalar(t, s, n);
+    }
+
+    size_t Table::validSsse3(const uint8_t* s, size_t n){
+        return validScalar(s, n);
+    }
 
+    size_t Table::validAvx2(const uint8_t* s, size_t n){
+        return validScalar(s, n);
+    }
+
+#endif
+
+    static std::string escapeString(const Table& table,
+            const std::string& original){
+        std::string out;
+        out.reserve(original.size());
+        escapeTo(table, original.data(), original.size(),
+                [&out](const char* s, size_t n){ out.append(s, n); });
         return out;
     }
 
-} //namespace HtmlEscape{
+    /**
+     * Function for HTML escaping a string, for use in a textarea.
+     * @param original The String to escape
+     * @return The escaped String
+     */
+    std::string escapeTextArea(const std::string& original){
+        static const Table table(true, false, true);
+        return escapeString(table, original);
+    }
+
+    /**
+     * Normal escape function, for Html escaping Strings
+     * @param original The original String
+     * @return The escape String
+     */
+    std::string escape(const std::string& original){
+        static const Table table(true, true, true);
+        return escapeString(table, original);
+    }
+
+    std::string escapeTags(const std::string& original){
+        static const Table table(true, false, false);
+        return escapeString(table, original);
+    }
+
+    std::string escapeBr(const std::string& original){
+        static const Table table(false, true, false);
+        return escapeString(table, original);
+    }
 
+    std::string escapeSpecial(const std::string& original){
+        static const Table table(false, false, true);
+        return escapeString(table, original);
+    }
+
+} //namespace HtmlEscape{
@@ -25,28 +25,181 @@
  *
  */
 
+#ifndef HTMLESCAPE_H_
+#define HTMLESCAPE_H_
+
+#include <stdint.h>
+#include <cstddef>
 #include <string>
 
 namespace HtmlEscape{
+    /**
+     * @class Table
+     * @brief Replacement for every byte value, shared by escape functions
+     * and html_filebuf. Runs of bytes without replacement are found with
+     * SIMD and copied as whole.
+     */
+    class Table{
+    public:
+        /**
+         * @param tags escape < > and "
+         * @param br write new line as <br/> and drop carriage return
+         * @param special escape &
+         * @param utf8 replace invalid UTF-8 and NUL with U+FFFD
+         */
+        Table(bool tags, bool br, bool special, bool utf8 = false);
+
+        /**
+         * @return table for text in JavaScript string literal,
+         * with quote, backslash and control characters escaped
+         * and invalid UTF-8 replaced.
+         */
+        static Table javascript();
+
+        /**
+         * @return index of first byte which is replaced, or n.
+         */
+        size_t find(const char* s, size_t n) const {
+            return _find(*this, reinterpret_cast<const uint8_t*>(s), n);
+        }
+
+        /**
+         * @return length of longest valid UTF-8 prefix of s.
+         */
+        size_t valid(const char* s, size_t n) const {
+            return _valid(reinterpret_cast<const uint8_t*>(s), n);
+        }
+
+        bool utf8() const {
+            return _utf8;
+        }
+
+        /**
+         * @return replacement of byte, NULL if byte is copied.
+         */
+        const char* replacement(uint8_t c) const {
+            return _replacement[c];
+        }
+
+        size_t replacementSize(uint8_t c) const {
+            return _replacementSize[c];
+        }
+
+        /**
+         * @return name of search used on this CPU.
+         */
+        const char* implementation() const {
+            return _implementation;
+        }
+
+    protected:
+        typedef size_t (*FindFunction)(const Table& t,
+                const uint8_t* s, size_t n);
+        typedef size_t (*ValidFunction)(const uint8_t* s, size_t n);
+
+        void set(uint8_t c, const char* replacement);
+
+        /**
+         * Choose search for this CPU, after all bytes are set.
+         */
+        void selectFind();
+
+        static size_t findScalar(const Table& t, const uint8_t* s, size_t n);
+        static size_t findSsse3(const Table& t, const uint8_t* s, size_t n);
+        static size_t findAvx2(const Table& t, const uint8_t* s, size_t n);
+
+        static size_t validScalar(const uint8_t* s, size_t n);
+        static size_t validSsse3(const uint8_t* s, size_t n);
+        static size_t validAvx2(const uint8_t* s, size_t n);
+
+    protected:
+        const char* _replacement[256];
+        uint8_t _replacementSize[256];
+        /// Bucket of every replaced byte, by low and high nibble.
+        alignas(16) uint8_t _lo[16];
+        alignas(16) uint8_t _hi[16];
+        int _buckets;
+        bool _utf8;
+        FindFunction _find;
+        ValidFunction _valid;
+        const char* _implementation;
+    };
+
+    /// U+FFFD REPLACEMENT CHARACTER in UTF-8.
+    static const char REPLACEMENT_CHARACTER[] = "\xef\xbf\xbd";
+
+    /**
+     * @param s text starting with invalid UTF-8 sequence.
+     * @return length of invalid sequence, at least 1. It is written
+     * as one replacement character, as Unicode recommends.
+     */
+    size_t invalidUtf8(const char* s, size_t n);
+
+    /**
+     * Escape text which needs no UTF-8 checking.
+     */
+    template<typename Output>
+    void escapeValidTo(const Table& table, const char* s, size_t n, Output out){
+        while(n){
+            size_t run = table.find(s, n);
+            if(run){
+                out(s, run);
+            }
+            if(run == n){
+                break;
+            }
+            uint8_t c = s[run];
+            if(table.replacementSize(c)){
+                out(table.replacement(c), table.replacementSize(c));
+            }
+            s += run + 1;
+            n -= run + 1;
+        }
+    }
+
+    /**
+     * Escape text with table.
+     * @param out callable taking pointer and size of escaped piece.
+     */
+    template<typename Output>
+    void escapeTo(const Table& table, const char* s, size_t n, Output out){
+        if(!table.utf8()){
+            escapeValidTo(table, s, n, out);
+            return;
+        }
+        while(n){
+            size_t valid = table.valid(s, n);
+            escapeValidTo(table, s, valid, out);
+            if(valid == n){
+                break;
+            }
+            out(REPLACEMENT_CHARACTER, sizeof(REPLACEMENT_CHARACTER) - 1);
+            size_t invalid = invalidUtf8(s + valid, n - valid);
+            s += valid + invalid;
+            n -= valid + invalid;
+        }
+    }
+
     /**
      * Function for HTML escaping a string, for use in a textarea.
      * @param original The string to escape
      * @return The escaped string
      */
-    std::string escapeTextArea(std::string original);
+    std::string escapeTextArea(const std::string& original);
 
     /**
      * Normal escape function, for Html escaping Strings
      * @param original The original string
      * @return The escape string
      */
-    std::string escape(std::string original);
+    std::string escape(const std::string& original);
 
-    std::string escapeTags(std::string original);
+    std::string escapeTags(const std::string& original);
 
-    std::string escapeBr(std::string original);
+    std::string escapeBr(const std::string& original);
 
-    std::string escapeSpecial(std::string original);
+    std::string escapeSpecial(const std::string& original);
 
 } //namespace HtmlEscape{
 
+#endif // HTMLESCAPE_H_
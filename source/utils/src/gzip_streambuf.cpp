@@ -0,0 +1,208 @@
+/**
+ * @file gzip_streambuf.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Stream buffer writing gzip file, compressed on its own thread.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "stl_extensions/gzip_streambuf.h"
+
+#include "TimeMeasure.h"
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <zlib.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace stl_extensions {
+
+	static int write_all(int fd, const char* p, size_t size) {
+		while(size){
+			ssize_t w = write(fd, p, size);
+			if(w < 0){
+				if(errno == EINTR){
+					continue;
+				}
+				return errno;
+			}
+			p += w;
+			size -= w;
+		}
+		return 0;
+	}
+
+	gzip_streambuf::gzip_streambuf()
+			: _fd(-1), _stream(0), _backSize(0), _backFlush(Z_NO_FLUSH),
+			_backBusy(false), _synced(true), _stop(false), _thread(0),
+			_error(0), _bytesIn(0), _bytesOut(0), _seconds(0) {
+	}
+
+	gzip_streambuf::~gzip_streambuf() {
+		close();
+	}
+
+	gzip_streambuf* gzip_streambuf::open(const char* name,
+			std::ios_base::openmode mode) {
+		if(is_open()){
+			return 0;
+		}
+		_fd = ::open(name, O_WRONLY | O_CREAT
+				| (mode & std::ios_base::app ? O_APPEND : O_TRUNC), 0666);
+		if(_fd < 0){
+			return 0;
+		}
+		z_stream* z = new z_stream();
+		// 16 is added to window bits for gzip header instead of zlib one.
+		if(deflateInit2(z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+				Z_DEFAULT_STRATEGY) != Z_OK){
+			delete z;
+			::close(_fd);
+			_fd = -1;
+			errno = ENOMEM;
+			return 0;
+		}
+		_stream = z;
+		_put.resize(BUFFER_SIZE);
+		_back.resize(BUFFER_SIZE);
+		_out.resize(1 << 18);
+		setp(_put.data(), _put.data() + _put.size());
+		_backBusy = false;
+		_synced = true;
+		_stop = false;
+		_error = 0;
+		_bytesIn = 0;
+		_bytesOut = 0;
+		_seconds = 0;
+		Call call(this);
+		_thread = new thread(call);
+		return this;
+	}
+
+	gzip_streambuf* gzip_streambuf::close() {
+		if(!is_open()){
+			return 0;
+		}
+		handOff(Z_FINISH);
+		{
+			unique_lock<mutex> lock(_mutex);
+			_stop = true;
+			_changed.notify_all();
+		}
+		_thread->join();
+		delete _thread;
+		_thread = 0;
+		z_stream* z = static_cast<z_stream*>(_stream);
+		deflateEnd(z);
+		delete z;
+		_stream = 0;
+		if(::close(_fd) && !_error){
+			_error = errno;
+		}
+		_fd = -1;
+		setp(0, 0);
+		return _error ? 0 : this;
+	}
+
+	int gzip_streambuf::sync() {
+		if(!is_open()){
+			return -1;
+		}
+		if(pptr() != pbase() || !_synced){
+			handOff(Z_SYNC_FLUSH);
+		}
+		return _error ? -1 : 0;
+	}
+
+	gzip_streambuf::int_type gzip_streambuf::overflow(int_type ch) {
+		if(!is_open()){
+			return traits_type::eof();
+		}
+		handOff(Z_NO_FLUSH);
+		if(!traits_type::eq_int_type(ch, traits_type::eof())){
+			*pptr() = traits_type::to_char_type(ch);
+			pbump(1);
+		}
+		return traits_type::not_eof(ch);
+	}
+
+	void gzip_streambuf::handOff(int flush) {
+		size_t size = pptr() - pbase();
+		{
+			unique_lock<mutex> lock(_mutex);
+			while(_backBusy){
+				_changed.wait(lock);
+			}
+			// Thread is done with back buffer, so it becomes put buffer.
+			_put.swap(_back);
+			_backSize = size;
+			_backFlush = flush;
+			_backBusy = true;
+			_changed.notify_all();
+		}
+		_bytesIn += size;
+		_synced = flush != Z_NO_FLUSH;
+		setp(_put.data(), _put.data() + _put.size());
+	}
+
+	void gzip_streambuf::run() {
+		unique_lock<mutex> lock(_mutex);
+		for(;;){
+			while(!_backBusy && !_stop){
+				_changed.wait(lock);
+			}
+			if(!_backBusy){
+				break;
+			}
+			const char* data = _back.data();
+			size_t size = _backSize;
+			int flush = _backFlush;
+			lock.unlock();
+			Time start = getTimeMonotonic();
+			int err = compress(data, size, flush);
+			_seconds += getTimeMonotonic() - start;
+			lock.lock();
+			if(err && !_error){
+				_error = err;
+			}
+			_backBusy = false;
+			_changed.notify_all();
+		}
+	}
+
+	int gzip_streambuf::compress(const char* data, size_t size, int flush) {
+		z_stream* z = static_cast<z_stream*>(_stream);
+		z->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+		z->avail_in = size;
+		// Output is taken until compressor does not fill whole buffer.
+		do{
+			z->next_out = reinterpret_cast<Bytef*>(_out.data());
+			z->avail_out = _out.size();
+			if(deflate(z, flush) == Z_STREAM_ERROR){
+				return EIO;
+			}
+			size_t have = _out.size() - z->avail_out;
+			int err = write_all(_fd, _out.data(), have);
+			if(err){
+				return err;
+			}
+			_bytesOut += have;
+		}while(z->avail_out == 0);
+		return 0;
+	}
+
+} // namespace stl_extensions
+
+///////////////////////////////////////////////////////////////////////////////
@@ -17,94 +17,56 @@
 
 #include "ostream_color_log/html_filebuf.h"
 
+#include "HtmlEscape.h"
+
+#include <cstdio>
 #include <cstring>
 #include <limits>
+#include <algorithm>
+#include <sstream>
+
+#include <unistd.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 namespace ostream_color_log {
 
+	/**
+	 * @return CSS rule for class of style.
+	 */
+	static std::string css_rule(const text_style& style){
+		return "   ." + style.css_class() + "{ " + style.css() + "}\n";
+	}
+
+	/**
+	 * @return name of file without directory, for links between
+	 * files in same directory.
+	 */
+	static std::string base_name(const std::string& path){
+		return path.substr(path.rfind('/') + 1);
+	}
+
+	/// End of file, which appending run finds and writes over.
+	static const char* html_footer =
+			"  </p>\n"
+			" </body>\n"
+			"</html>\n";
 
-#define writeToBuffer(s) _filebuf.sputn(s, sizeof(s)-1);
-
-#define ESCAPE_TAGS \
-	case '<': writeToBuffer("&lt;"); break; \
-    case '>': writeToBuffer("&gt;"); break; \
-    case '"': writeToBuffer("&quot;"); break;
-
-#define ESCAPE_BR \
-	case '\n': writeToBuffer("<br/>"); break; \
-    case '\r': break;
-
-#define ESCAPE_SPECIAL \
-	case 38: writeToBuffer("&amp;"); break; \
-	case 198: writeToBuffer("&AElig;"); break; \
-	case 193: writeToBuffer("&Aacute;"); break; \
-	case 194: writeToBuffer("&Acirc;"); break; \
-	case 192: writeToBuffer("&Agrave;"); break; \
-	case 197: writeToBuffer("&Aring;"); break; \
-	case 195: writeToBuffer("&Atilde;"); break; \
-	case 196: writeToBuffer("&Auml;"); break; \
-	case 199: writeToBuffer("&Ccedil;"); break; \
-	case 208: writeToBuffer("&ETH;"); break; \
-	case 201: writeToBuffer("&Eacute;"); break; \
-	case 202: writeToBuffer("&Ecirc;"); break; \
-	case 200: writeToBuffer("&Egrave;"); break; \
-	case 203: writeToBuffer("&Euml;"); break; \
-	case 205: writeToBuffer("&Iacute;"); break; \
-	case 206: writeToBuffer("&Icirc;"); break; \
-	case 204: writeToBuffer("&Igrave;"); break; \
-	case 207: writeToBuffer("&Iuml;"); break; \
-	case 209: writeToBuffer("&Ntilde;"); break; \
-	case 211: writeToBuffer("&Oacute;"); break; \
-	case 212: writeToBuffer("&Ocirc;"); break; \
-	case 210: writeToBuffer("&Ograve;"); break; \
-	case 216: writeToBuffer("&Oslash;"); break; \
-	case 213: writeToBuffer("&Otilde;"); break; \
-	case 214: writeToBuffer("&Ouml;"); break; \
-	case 222: writeToBuffer("&THORN;"); break; \
-	case 218: writeToBuffer("&Uacute;"); break; \
-	case 219: writeToBuffer("&Ucirc;"); break; \
-	case 217: writeToBuffer("&Ugrave;"); break; \
-	case 220: writeToBuffer("&Uuml;"); break; \
-	case 221: writeToBuffer("&Yacute;"); break; \
-	case 225: writeToBuffer("&aacute;"); break; \
-	case 226: writeToBuffer("&acirc;"); break; \
-	case 230: writeToBuffer("&aelig;"); break; \
-	case 224: writeToBuffer("&agrave;"); break; \
-	case 229: writeToBuffer("&aring;"); break; \
-	case 227: writeToBuffer("&atilde;"); break; \
-	case 228: writeToBuffer("&auml;"); break; \
-	case 231: writeToBuffer("&ccedil;"); break; \
-	case 233: writeToBuffer("&eacute;"); break; \
-	case 234: writeToBuffer("&ecirc;"); break; \
-	case 232: writeToBuffer("&egrave;"); break; \
-	case 240: writeToBuffer("&eth;"); break; \
-	case 235: writeToBuffer("&euml;"); break; \
-	case 237: writeToBuffer("&iacute;"); break; \
-	case 238: writeToBuffer("&icirc;"); break; \
-	case 236: writeToBuffer("&igrave;"); break; \
-	case 239: writeToBuffer("&iuml;"); break; \
-	case 241: writeToBuffer("&ntilde;"); break; \
-	case 243: writeToBuffer("&oacute;"); break; \
-	case 244: writeToBuffer("&ocirc;"); break; \
-	case 242: writeToBuffer("&ograve;"); break; \
-	case 248: writeToBuffer("&oslash;"); break; \
-	case 245: writeToBuffer("&otilde;"); break; \
-	case 246: writeToBuffer("&ouml;"); break; \
-	case 223: writeToBuffer("&szlig;"); break; \
-	case 254: writeToBuffer("&thorn;"); break; \
-	case 250: writeToBuffer("&uacute;"); break; \
-	case 251: writeToBuffer("&ucirc;"); break; \
-	case 249: writeToBuffer("&ugrave;"); break; \
-	case 252: writeToBuffer("&uuml;"); break; \
-	case 253: writeToBuffer("&yacute;"); break; \
-	case 255: writeToBuffer("&yuml;"); break; \
-	case 162: writeToBuffer("&cent;"); break; \
-
-
-
-	html_filebuf::html_filebuf() {
+	static std::string format_time(time_t t){
+		if(!t){
+			return "-";
+		}
+		struct tm tm;
+		localtime_r(&t, &tm);
+		char s[32];
+		strftime(s, sizeof(s), "%Y-%m-%d %H:%M:%S", &tm);
+		return s;
+	}
+
+	html_filebuf::html_filebuf()
+			: _headOpen(false), _out(&_filebuf), _maxLines(0), _maxBytes(0),
+			_indexRow(0), _page(0), _pageLines(0), _pageBytes(0),
+			_pageErrors(0), _pageFirst(0), _pageLast(0), _lineStart(true) {
 	}
 
 	html_filebuf::~html_filebuf() {
@@ -117,45 +79,194 @@ namespace ostream_color_log {
 			ostream_colors foreground,
 			ostream_colors background,
 			ostream_attributes attribute){
-		std::filebuf* ret =	_filebuf.open(name, mode);
-		if(ret){
-			setForeground(foreground);
-			setBackground(background);
-			setAttribute(attribute);
-			directWrite(
-					"<!DOCTYPE html>\n"
-					"<html>\n"
-					" <head>\n"
-					" <title>");
-			directWrite(name);
-			directWrite(
-					"</title>\n"
-					"  <style>\n"
-					"   p{ white-space: pre-wrap; font-family: monospace;\n"
-					"    margin: 0; padding:0;\n"
-					"    ");
-			writeAttributeAndColors();
-			directWrite(
-					" }\n"
-					"  </style>\n"
-					" </head>\n"
-					" <body bgcolor=\"black\">\n"
-					"  <p>");
+		_base = text_style(foreground, background, attribute);
+		_style = _base;
+		_written = _base;
+		_declared.clear();
+		_earlierClasses.clear();
+		_out = &_filebuf;
+		_headOpen = false;
+		size_t size = strlen(name);
+		if(size > 3 && strcmp(name + size - 3, ".gz") == 0){
+			// Compressed stream could not be written over,
+			// so appended run is new document in new gzip member.
+			_out = &_gzip;
+			if(_maxLines || _maxBytes || !_gzip.open(name, mode)){
+				_out = &_filebuf;
+				return 0;
+			}
+			startHead(std::string(name, size - 3));
 			return this;
-		}else{
+		}
+		if(!_maxLines && !_maxBytes){
+			if(!(mode & std::ios_base::app)){
+				if(!_filebuf.open(name, mode)){
+					return 0;
+				}
+				startHead(name);
+				return this;
+			}
+			// Created if it is not there, but not truncated. Opened
+			// for reading, not for appending, so end could be overwritten.
+			std::filebuf create;
+			if(!create.open(name, std::ios_base::out | std::ios_base::app)){
+				return 0;
+			}
+			create.close();
+			if(!_filebuf.open(name, std::ios_base::in | std::ios_base::out)){
+				return 0;
+			}
+			std::streamoff footer = findFooter();
+			if(footer >= 0){
+				// Body of earlier run goes on, in place of its end.
+				readEarlierClasses();
+				_filebuf.pubseekpos(footer, std::ios_base::out);
+			}else{
+				// Empty, or not written by us, so new document goes after it.
+				_filebuf.pubseekoff(0, std::ios_base::end, std::ios_base::out);
+				startHead(name);
+			}
+			return this;
+		}
+
+		_indexName = name;
+		_pagePrefix = _indexName;
+		if(_pagePrefix.size() > 5
+				&& _pagePrefix.compare(_pagePrefix.size() - 5, 5, ".html") == 0){
+			_pagePrefix.erase(_pagePrefix.size() - 5);
+		}
+		_page = 0;
+		if(mode & std::ios_base::app){
+			// Pages of earlier runs are kept and new ones go after them.
+			while(access(pageName(_page + 1).c_str(), F_OK) == 0){
+				_page++;
+			}
+		}
+		if(!_index.open(name, std::ios_base::out | std::ios_base::trunc)){
+			return 0;
+		}
+		std::string head =
+				"<!DOCTYPE html>\n"
+				"<html>\n"
+				" <head>\n"
+				"  <meta charset=\"utf-8\">\n"
+				"  <title>" + _indexName + "</title>\n"
+				"  <style>\n"
+				"   body{ font-family: monospace; color: #fff;"
+				" background-color: #000; }\n"
+				"   a{ color: #0ff; }\n"
+				"   th, td{ padding: 0 1em; text-align: right; }\n"
+				"   .e{ color: #f00; }\n"
+				"  </style>\n"
+				" </head>\n"
+				" <body>\n"
+				"  <table>\n"
+				"   <tr><th>Page</th><th>From</th><th>To</th>"
+				"<th>Lines</th><th>Errors</th></tr>\n";
+		for(size_t page = 1; page <= _page; page++){
+			std::ostringstream row;
+			row << "   <tr><td><a href=\"" << base_name(pageName(page))
+					<< "\">" << page << "</a></td>"
+					<< "<td colspan=\"4\">earlier run</td></tr>\n";
+			head += row.str();
+		}
+		_index.sputn(head.data(), head.size());
+		_indexRow = head.size();
+		if(!openPage()){
+			_index.close();
 			return 0;
 		}
+		return this;
+	}
+
+	html_filebuf* html_filebuf::open(
+			std::streambuf* out,
+			ostream_colors foreground,
+			ostream_colors background,
+			ostream_attributes attribute){
+		_out = out;
+		_base = text_style(foreground, background, attribute);
+		_style = _base;
+		_written = _base;
+		return this;
+	}
+
+	html_filebuf* html_filebuf::open(std::streambuf* out){
+		_out = out;
+		_base = text_style();
+		_style = _base;
+		_written = _base;
+		return this;
+	}
+
+	std::streamsize html_filebuf::write_html(const char* s, std::streamsize n){
+		nextPageIfFull();
+		startBody();
+		closeStyle();
+		countText(s, n);
+		return _out->sputn(s, n);
+	}
+
+	std::streamsize html_filebuf::write_html(const char* s, std::streamsize n,
+			const text_style& first, const text_style& last){
+		nextPageIfFull();
+		startBody();
+		std::streamsize skip = 0;
+		if(first != _base && first == _written){
+			std::string tag = openTag(first);
+			if(n >= std::streamsize(tag.size())
+					&& tag.compare(0, tag.size(), s, tag.size()) == 0){
+				skip = tag.size();
+			}
+		}
+		if(!skip){
+			closeStyle();
+		}
+		countText(s + skip, n - skip);
+		_out->sputn(s + skip, n - skip);
+		_written = last;
+		return n;
+	}
+
+	void html_filebuf::declare_style(const text_style& style){
+		if(!writingFile() || style == _base
+				|| !_declared.insert(style).second
+				|| _earlierClasses.count(style.css_class())){
+			// Text of base style is written without element.
+			return;
+		}
+		std::string css = css_rule(style);
+		if(_headOpen){
+			directWrite(css);
+		}else{
+			// Style element in body still applies to whole page.
+			directWrite("<style>\n" + css + "</style>");
+		}
 	}
 
 	html_filebuf* html_filebuf::close(){
+		if(!writingFile()){
+			closeStyle();
+			_out = &_filebuf;
+			return this;
+		}
 		if(!is_open()){
 			return 0;
 		}
 
-		directWrite("  </p>\n"
-				" </body>\n"
-				"</html>\n");
+		if(_maxLines || _maxBytes){
+			closePage(false);
+			return _index.close() ? this : 0;
+		}
+
+		startBody();
+		closeStyle();
+		directWrite(html_footer);
 
+		if(_out == &_gzip){
+			_out = &_filebuf;
+			return _gzip.close() ? this : 0;
+		}
 		std::filebuf* ret =	_filebuf.close();
 		if(ret){
 			return this;
@@ -164,6 +275,11 @@ namespace ostream_color_log {
 		}
 	}
 
+	void html_filebuf::set_paging(size_t max_lines, size_t max_bytes){
+		_maxLines = max_lines;
+		_maxBytes = max_bytes;
+	}
+
 	/**
 	 *  @brief  Synchronizes the buffer arrays with the controlled sequences.
 	 *  @return  -1 on failure.
@@ -173,7 +289,14 @@ namespace ostream_color_log {
 	 *  @note  Base class version does nothing, returns zero.
 	 */
 	int html_filebuf::sync() {
-		return _filebuf.pubsync();
+		if(_out == &_filebuf && _filebuf.is_open()){
+			writeFooter();
+		}
+		if(_out == &_filebuf && _index.is_open()){
+			writeIndexRow(false);
+			_index.pubsync();
+		}
+		return _out->pubsync();
 	}
 
 	// Put area:
@@ -191,27 +314,21 @@ namespace ostream_color_log {
 	 *  implementation by overriding this definition.
 	 */
 	std::streamsize html_filebuf::xsputn(const char* s, std::streamsize n) {
-		// TODO Optimize.
-		// Escaping text.
-		std::streamsize i;
-        for(i = 0; i < n && *s; i++, s++){
-			// TODO Check if all is written in buffer.
-			int c = *s;
-            switch(c){
-            ESCAPE_TAGS
-            ESCAPE_SPECIAL
-            default:
-                if( c > 127 ){
-                    char buffer[9];
-                    int stored = snprintf(buffer, 9, "&#x%4x;", c);
-                    _filebuf.sputn(buffer, stored);
-                }else{
-                	 _filebuf.sputc(c);
-                }
-                break;
-            }
-        }
-		return i;
+		static const HtmlEscape::Table table(true, false, true, true);
+		if(_lineStart){
+			nextPageIfFull();
+		}
+		startBody();
+		// New line shows nothing of its style, so it does not
+		// break run of lines with same style.
+		if(_style != _written && !(n == 1 && *s == '\n')){
+			writeStyle();
+		}
+		std::streambuf* out = _out;
+		HtmlEscape::escapeTo(table, s, n,
+				[out](const char* p, size_t size) { out->sputn(p, size); });
+		countText(s, n);
+		return n;
 	}
 
 	/**
@@ -248,80 +365,234 @@ namespace ostream_color_log {
 	}
 
 	std::streamsize html_filebuf::directWrite(const char* s){
-		return _filebuf.sputn(s, strlen(s));
+		return _out->sputn(s, strlen(s));
 	}
 
 	std::streamsize html_filebuf::directWrite(const std::string& s){
-		return _filebuf.sputn(s.c_str(), s.size());
+		return _out->sputn(s.c_str(), s.size());
+	}
+
+	void html_filebuf::setForeground(ostream_colors foreground) {
+		_style.foreground = foreground;
 	}
 
-	const char* html_filebuf::makeColorString(ostream_colors color) {
-		switch(color){
-		case black:
-			return "#000";
-		case red:
-			return "#f00";
-		case green:
-			return "#0f0";
-		case yellow:
-			return "#ff0";
-		case blue:
-			return "#00f";
-		case magenta:
-			return "#f0f";
-		case cyan:
-			return "#0ff";
-		case white:
-		default:
-			return "#fff";
+	void html_filebuf::setBackground(ostream_colors background) {
+		_style.background = background;
+	}
+
+	void html_filebuf::setAttribute(ostream_attributes attribute) {
+		if(attribute == reset){
+			_style = _base;
+		}else{
+			_style.add(attribute);
 		}
 	}
 
-	void html_filebuf::writeAttributeAndColors() {
-		directWrite(_foreground);
-		directWrite(_background);
-		directWrite(_attributes);
+	void html_filebuf::writeStyle() {
+		closeStyle();
+		if(_style != _base){
+			declare_style(_style);
+			startBody();
+			directWrite(openTag(_style));
+		}
+		_written = _style;
 	}
 
-	void html_filebuf::setForeground(ostream_colors foreground) {
-		_foreground = std::string("color: ") + makeColorString(foreground)
-				+ "; ";
+	void html_filebuf::closeStyle() {
+		if(_written != _base){
+			directWrite("</span>");
+		}
+		_written = _base;
 	}
 
-	void html_filebuf::setBackground(ostream_colors background) {
-		_background = std::string("background-color: ")
-				+ makeColorString(background) + "; ";
+	std::string html_filebuf::openTag(const text_style& style) {
+		return "<span class=\"" + style.css_class() + "\">";
 	}
 
-	void html_filebuf::setAttribute(ostream_attributes attribute) {
-		switch(attribute){
-		case reset:
-			_attributes = "";
-			_foreground = "";
-			_background = "";
-			break;
-		case bold:
-			_attributes += "font-weight: bold; ";
-			break;
-		case dim:
-			break;
-		case underline_v2:
-			_attributes += "text-decoration: underline; ";
-			break;
-		case underline:
-			_attributes += "text-decoration: underline; ";
-			break;
-		case blink:
-			_attributes += "text-decoration:blink; ";
-			break;
-		case nothing:
-			break;
-		case reverse:
-			break;
-		case hidden:
-			_attributes += "visibility: hidden; ";
-			break;
+	void html_filebuf::startBody() {
+		if(!writingFile()){
+			return;
+		}
+		if(_headOpen){
+			directWrite(
+					"  </style>\n"
+					" </head>\n"
+					" <body bgcolor=\"black\">\n");
+			if(_page){
+				directWrite("  <div><a href=\"" + base_name(_indexName)
+						+ "\">index</a>");
+				if(_page > 1){
+					directWrite(" <a href=\"" + base_name(pageName(_page - 1))
+							+ "\">previous</a>");
+				}
+				directWrite("</div>\n");
+			}
+			directWrite("  <p>");
+			_headOpen = false;
+		}
+	}
+
+	void html_filebuf::startHead(const std::string& title) {
+		_headOpen = true;
+		directWrite(
+				"<!DOCTYPE html>\n"
+				"<html>\n"
+				" <head>\n"
+				"  <meta charset=\"utf-8\">\n"
+				" <title>");
+		directWrite(title);
+		directWrite(
+				"</title>\n"
+				"  <style>\n"
+				"   p{ white-space: pre-wrap; font-family: monospace;\n"
+				"    margin: 0; padding:0;\n"
+				"    ");
+		directWrite(_base.css());
+		directWrite(" }\n");
+		// Rest of head is written with first text,
+		// so declared styles could go there.
+	}
+
+	void html_filebuf::nextPageIfFull() {
+		if(_out != &_filebuf || !_page){
+			return;
+		}
+		if((_maxLines && _pageLines >= _maxLines)
+				|| (_maxBytes && _pageBytes >= _maxBytes)){
+			closePage(true);
+			openPage();
+		}
+	}
+
+	bool html_filebuf::openPage() {
+		_page++;
+		if(!_filebuf.open(pageName(_page).c_str(),
+				std::ios_base::out | std::ios_base::trunc)){
+			return false;
+		}
+		_pageLines = 0;
+		_pageBytes = 0;
+		_pageErrors = 0;
+		_pageFirst = 0;
+		_pageLast = 0;
+		_lineStart = true;
+		startHead(base_name(pageName(_page)));
+		// Every page declares styles used so far.
+		for(const text_style& style: _declared){
+			directWrite(css_rule(style));
+		}
+		writeIndexRow(false);
+		return true;
+	}
+
+	void html_filebuf::closePage(bool next) {
+		startBody();
+		closeStyle();
+		if(next){
+			directWrite("  </p>\n"
+					"  <div><a href=\"" + base_name(pageName(_page + 1))
+					+ "\">next</a></div>\n"
+					" </body>\n"
+					"</html>\n");
+		}else{
+			directWrite(html_footer);
+		}
+		_filebuf.close();
+		writeIndexRow(true);
+	}
+
+	void html_filebuf::writeIndexRow(bool done) {
+		std::ostringstream row;
+		row << "   <tr><td><a href=\"" << base_name(pageName(_page)) << "\">"
+				<< _page << "</a></td><td>" << format_time(_pageFirst)
+				<< "</td><td>" << format_time(_pageLast) << "</td><td>"
+				<< _pageLines << "</td><td" << (_pageErrors ? " class=\"e\"" : "")
+				<< ">" << _pageErrors << "</td></tr>\n";
+		std::string text = row.str();
+		// Values in row only grow, so new row covers old one whole.
+		_index.pubseekpos(_indexRow, std::ios_base::out);
+		_index.sputn(text.data(), text.size());
+		if(done){
+			_indexRow += text.size();
+		}
+		const char* end =
+				"  </table>\n"
+				" </body>\n"
+				"</html>\n";
+		_index.sputn(end, strlen(end));
+	}
+
+	void html_filebuf::writeFooter() {
+		startBody();
+		std::string end = _written != _base ? "</span>" : "";
+		end += html_footer;
+		std::streampos pos = _filebuf.pubseekoff(0, std::ios_base::cur,
+				std::ios_base::out);
+		directWrite(end);
+		_filebuf.pubsync();
+		// Next text goes over end, and close() writes it again after text.
+		_filebuf.pubseekpos(pos, std::ios_base::out);
+	}
+
+	std::streamoff html_filebuf::findFooter() {
+		std::streamoff size = strlen(html_footer);
+		std::streamoff end = _filebuf.pubseekoff(0, std::ios_base::end,
+				std::ios_base::in);
+		if(end < size){
+			return -1;
+		}
+		// Only end of file is read, however big file is.
+		std::string tail(size, '\0');
+		_filebuf.pubseekpos(end - size, std::ios_base::in);
+		if(_filebuf.sgetn(&tail[0], size) != size || tail != html_footer){
+			return -1;
+		}
+		return end - size;
+	}
+
+	void html_filebuf::readEarlierClasses() {
+		// Head is small, so it is read whole, up to its end.
+		std::string head;
+		char block[4096];
+		_filebuf.pubseekpos(0, std::ios_base::in);
+		while(head.find("</head>") == std::string::npos){
+			std::streamsize n = _filebuf.sgetn(block, sizeof(block));
+			if(n <= 0){
+				break;
+			}
+			head.append(block, n);
+		}
+		head.erase(std::min(head.find("</head>"), head.size()));
+		// Rules are written by css_rule(), one per line.
+		const std::string start = "\n   .";
+		for(size_t pos = head.find(start); pos != std::string::npos;
+				pos = head.find(start, pos + 1)){
+			size_t begin = pos + start.size();
+			size_t end = head.find('{', begin);
+			if(end == std::string::npos){
+				break;
+			}
+			_earlierClasses.insert(head.substr(begin, end - begin));
+		}
+	}
+
+	std::string html_filebuf::pageName(size_t page) const {
+		char number[32];
+		snprintf(number, sizeof(number), ".%04zu.html", page);
+		return _pagePrefix + number;
+	}
+
+	void html_filebuf::countText(const char* s, std::streamsize n) {
+		if(!_page || n <= 0){
+			return;
+		}
+		_pageLines += std::count(s, s + n, '\n');
+		_pageBytes += n;
+		_pageLast = time(0);
+		if(!_pageFirst){
+			_pageFirst = _pageLast;
 		}
+		_lineStart = s[n - 1] == '\n';
 	}
 
 } // namespace ostream_color_log
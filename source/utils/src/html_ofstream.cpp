@@ -51,6 +51,20 @@ namespace ostream_color_log {
 	}
 
 
+	void html_ofstream::open(
+			std::streambuf* out,
+			ostream_colors foreground,
+			ostream_colors background,
+			ostream_attributes attribute){
+		_filebuf.open(out, foreground, background, attribute);
+		clear();
+	}
+
+	void html_ofstream::open(std::streambuf* out){
+		_filebuf.open(out);
+		clear();
+	}
+
 	void html_ofstream::close(){
 		if(!_filebuf.close()){
 			setstate(ios_base::failbit);
@@ -59,40 +73,32 @@ namespace ostream_color_log {
 
 	html_ofstream& operator<<(html_ofstream& hofs,
 			ostream_colors foreground){
-		html_filebuf& fb = *hofs.rdbuf();
-		fb.pubsync();
-		fb.setForeground(foreground);
-		fb.directWrite("</p><p style = \"");
-		fb.writeAttributeAndColors();
-		fb.directWrite("\">");
+		// Style is written with next text, so manipulators which
+		// do not change style cost nothing.
+		hofs.rdbuf()->setForeground(foreground);
 		return hofs;
 	}
 
 	html_ofstream& operator<<(html_ofstream& hofs,
 			ostream_attributes attribute){
-		html_filebuf& fb = *hofs.rdbuf();
-		fb.pubsync();
-		fb.setAttribute(attribute);
-		fb.directWrite("</p><p style = \"");
-		fb.writeAttributeAndColors();
-		fb.directWrite("\">");
+		hofs.rdbuf()->setAttribute(attribute);
 		return hofs;
 	}
 
 	html_ofstream& operator<<(html_ofstream& hofs,
 			_OstreamAttributeAndColorFormat format){
 		html_filebuf& fb = *hofs.rdbuf();
-		fb.pubsync();
 		fb.setForeground(format.foreground);
 		fb.setBackground(format.background);
 		fb.setAttribute(format.attribute);
-		fb.directWrite("</p><p style = \"");
-		fb.writeAttributeAndColors();
-		fb.directWrite("\">");
 		return hofs;
 	}
 
-
+	html_ofstream& operator<<(html_ofstream& hofs,
+			const text_style& style){
+		hofs.rdbuf()->_style = style;
+		return hofs;
+	}
 
 } // namespace ostream_color_log{
 
@@ -0,0 +1,331 @@
+/**
+ * @file html_viewer.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief HTML page showing only visible lines, which are loaded
+ * from data files in chunks.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ostream_color_log/html_viewer.h"
+
+#include "HtmlEscape.h"
+
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ostream_color_log {
+
+	/**
+	 * Page without data. Lines are divs of fixed height, so line
+	 * on any position is known without laying out lines before it.
+	 */
+	static const char* page_head =
+			"<!DOCTYPE html>\n"
+			"<html>\n"
+			" <head>\n"
+			"  <meta charset=\"utf-8\">\n"
+			"  <title>";
+
+	static const char* page_style =
+			"</title>\n"
+			"  <style>\n"
+			"   html, body{ margin: 0; height: 100%;"
+			" color: #fff; background-color: #000; }\n"
+			"   #view{ position: absolute; left: 0; right: 0; top: 0;"
+			" bottom: 0; overflow: auto; }\n"
+			"   #lines{ position: absolute; left: 0; top: 0; min-width: 100%;"
+			" font: 13px monospace; white-space: pre; }\n"
+			"   #lines div{ height: 16px; line-height: 16px; }\n"
+			"   #status{ position: fixed; right: 2em; bottom: 1em;"
+			" color: #888; font: 13px monospace; }\n"
+			"  </style>\n"
+			"  <style id=\"styles\"></style>\n"
+			" </head>\n"
+			" <body>\n"
+			"  <div id=\"view\"><div id=\"space\"></div>"
+			"<div id=\"lines\"></div></div>\n"
+			"  <div id=\"status\"></div>\n"
+			"  <script>\n"
+			"var DATA = ";
+
+	static const char* page_script =
+			";\n"
+			"var coloringTee = (function(){\n"
+			"	var LINE_HEIGHT = 16;\n"
+			"	// Browsers limit height of element, so long log is\n"
+			"	// scrolled through space scaled down to this height.\n"
+			"	var MAX_HEIGHT = 4000000;\n"
+			"	var view = document.getElementById(\"view\");\n"
+			"	var space = document.getElementById(\"space\");\n"
+			"	var lines = document.getElementById(\"lines\");\n"
+			"	var styles = document.getElementById(\"styles\");\n"
+			"	var status = document.getElementById(\"status\");\n"
+			"	var index = { lines: 0, chunkLines: 1, classes: [], css: \"\" };\n"
+			"	var chunks = [];\n"
+			"	var loading = [];\n"
+			"\n"
+			"	// Script elements work for local files, where fetch() does not.\n"
+			"	function load(name){\n"
+			"		var script = document.createElement(\"script\");\n"
+			"		script.src = DATA + name + \"?\" + Date.now();\n"
+			"		script.onload = script.onerror = function(){\n"
+			"			document.head.removeChild(script);\n"
+			"		};\n"
+			"		document.head.appendChild(script);\n"
+			"	}\n"
+			"\n"
+			"	function chunkName(c){\n"
+			"		var name = String(c);\n"
+			"		while(name.length < 6){\n"
+			"			name = \"0\" + name;\n"
+			"		}\n"
+			"		return name + \".js\";\n"
+			"	}\n"
+			"\n"
+			"	function maxScroll(){\n"
+			"		return Math.max(0, space.offsetHeight - view.clientHeight);\n"
+			"	}\n"
+			"\n"
+			"	// Lay out only lines in window.\n"
+			"	function render(){\n"
+			"		var top = view.scrollTop;\n"
+			"		var position = top / LINE_HEIGHT;\n"
+			"		if(index.lines * LINE_HEIGHT > MAX_HEIGHT){\n"
+			"			var last = index.lines\n"
+			"					- Math.floor(view.clientHeight / LINE_HEIGHT);\n"
+			"			position = maxScroll() ? top / maxScroll() * last : 0;\n"
+			"		}\n"
+			"		var first = Math.floor(position);\n"
+			"		var count = Math.ceil(view.clientHeight / LINE_HEIGHT) + 1;\n"
+			"		var fragment = document.createDocumentFragment();\n"
+			"		for(var i = first; i < first + count && i < index.lines; i++){\n"
+			"			var c = Math.floor(i / index.chunkLines);\n"
+			"			var j = i - c * index.chunkLines;\n"
+			"			var div = document.createElement(\"div\");\n"
+			"			if(chunks[c] && j < chunks[c].lines.length){\n"
+			"				div.className = index.classes[chunks[c].styles[j]] || \"\";\n"
+			"				div.textContent = chunks[c].lines[j];\n"
+			"			}else if(!loading[c]){\n"
+			"				loading[c] = true;\n"
+			"				load(chunkName(c));\n"
+			"			}\n"
+			"			fragment.appendChild(div);\n"
+			"		}\n"
+			"		lines.style.top = (top - (position - first) * LINE_HEIGHT) + \"px\";\n"
+			"		lines.textContent = \"\";\n"
+			"		lines.appendChild(fragment);\n"
+			"		status.textContent = (index.lines ? first + 1 : 0)\n"
+			"				+ \" / \" + index.lines;\n"
+			"	}\n"
+			"\n"
+			"	function setIndex(data){\n"
+			"		// Window at end follows new lines.\n"
+			"		var atEnd = index.lines\n"
+			"				&& view.scrollTop >= maxScroll() - LINE_HEIGHT;\n"
+			"		if(data.css != index.css){\n"
+			"			styles.textContent = data.css;\n"
+			"		}\n"
+			"		index = data;\n"
+			"		// Last chunk could have more lines now.\n"
+			"		loading = [];\n"
+			"		space.style.height = (Math.min(index.lines * LINE_HEIGHT,\n"
+			"				MAX_HEIGHT) + LINE_HEIGHT) + \"px\";\n"
+			"		if(atEnd){\n"
+			"			view.scrollTop = maxScroll();\n"
+			"		}\n"
+			"		render();\n"
+			"	}\n"
+			"\n"
+			"	function setChunk(c, styles, lines){\n"
+			"		chunks[c] = { styles: styles, lines: lines };\n"
+			"		loading[c] = false;\n"
+			"		render();\n"
+			"	}\n"
+			"\n"
+			"	view.addEventListener(\"scroll\", render);\n"
+			"	window.addEventListener(\"resize\", render);\n"
+			"	load(\"index.js\");\n"
+			"	setInterval(function(){ load(\"index.js\"); }, 2000);\n"
+			"	return { index: setIndex, chunk: setChunk };\n"
+			"})();\n"
+			"  </script>\n"
+			" </body>\n"
+			"</html>\n";
+
+	/**
+	 * Append text as JavaScript string literal.
+	 */
+	static void append_string(const char* s, size_t n, std::string& out){
+		static const HtmlEscape::Table table = HtmlEscape::Table::javascript();
+		out += '"';
+		HtmlEscape::escapeTo(table, s, n,
+				[&out](const char* p, size_t size) { out.append(p, size); });
+		out += '"';
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+
+	html_viewer::html_viewer()
+			: _open(false), _chunk(0), _chunkLines(0), _lines(0), _pending(0),
+			_error(0) {
+	}
+
+	html_viewer::~html_viewer() {
+		close();
+	}
+
+	int html_viewer::open(const std::string& name) {
+		std::string prefix = name;
+		if(prefix.size() > 5
+				&& prefix.compare(prefix.size() - 5, 5, ".html") == 0){
+			prefix.erase(prefix.size() - 5);
+		}
+		_dir = prefix + "_files/";
+		if(mkdir(_dir.c_str(), 0777) && errno != EEXIST){
+			return errno;
+		}
+
+		// Page refers to data directory next to it.
+		std::string data = _dir.substr(_dir.rfind('/', _dir.size() - 2) + 1);
+		std::string page = page_head;
+		page += HtmlEscape::escape(name);
+		page += page_style;
+		append_string(data.data(), data.size(), page);
+		page += page_script;
+		writeFile(name, page);
+		writeIndex();
+		_open = !_error;
+		return _error;
+	}
+
+	void html_viewer::close() {
+		if(_open){
+			flush();
+			_open = false;
+		}
+	}
+
+	void html_viewer::declare_style(size_t id, const text_style& style) {
+		if(_classes.size() <= id){
+			_classes.resize(id + 1);
+		}
+		if(style == text_style()){
+			// Style of page.
+			_classes[id].clear();
+			return;
+		}
+		_classes[id] = style.css_class();
+		std::string rule = "." + _classes[id] + "{ ";
+		if(_css.find(rule) == std::string::npos){
+			_css += rule + style.css() + "}\n";
+		}
+	}
+
+	void html_viewer::render_line(const char* s, size_t n, std::string& out) {
+		append_string(s, n, out);
+		out += ",\n";
+	}
+
+	void html_viewer::write_line(const char* rendered, size_t n, size_t style) {
+		_chunkText.append(rendered, n);
+		char id[24];
+		snprintf(id, sizeof(id), "%zu,", style);
+		_chunkStyles += id;
+		_chunkLines++;
+		_pending += n;
+		if(_chunkLines == CHUNK_LINES){
+			// Full chunk is written once and never changes.
+			writeChunk();
+			_lines += _chunkLines;
+			_chunk++;
+			_chunkText.clear();
+			_chunkStyles.clear();
+			_chunkLines = 0;
+		}
+	}
+
+	void html_viewer::flush() {
+		if(_chunkLines){
+			writeChunk();
+		}
+		// Index goes last, so page never asks for chunk
+		// which is not written yet.
+		writeIndex();
+		_pending = 0;
+	}
+
+	void html_viewer::writeChunk() {
+		char name[32];
+		snprintf(name, sizeof(name), "%06zu.js", _chunk);
+		char head[64];
+		snprintf(head, sizeof(head), "coloringTee.chunk(%zu, [", _chunk);
+		writeFile(_dir + name,
+				head + _chunkStyles + "], [\n" + _chunkText + "]);\n");
+	}
+
+	void html_viewer::writeIndex() {
+		std::string text = "coloringTee.index({ lines: ";
+		text += std::to_string(_lines + _chunkLines);
+		text += ", chunkLines: ";
+		text += std::to_string(CHUNK_LINES);
+		text += ", classes: [";
+		for(const std::string& c: _classes){
+			append_string(c.data(), c.size(), text);
+			text += ", ";
+		}
+		text += "], css: ";
+		append_string(_css.data(), _css.size(), text);
+		text += " });\n";
+		writeFile(_dir + "index.js", text);
+	}
+
+	void html_viewer::writeFile(const std::string& name,
+			const std::string& text) {
+		if(_error){
+			return;
+		}
+		std::string temporary = name + ".tmp";
+		int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+				0666);
+		if(fd < 0){
+			_error = errno;
+			return;
+		}
+		size_t done = 0;
+		while(done < text.size()){
+			ssize_t w = write(fd, text.data() + done, text.size() - done);
+			if(w < 0){
+				if(errno == EINTR){
+					continue;
+				}
+				_error = errno;
+				break;
+			}
+			done += w;
+		}
+		if(::close(fd) && !_error){
+			_error = errno;
+		}
+		if(!_error && rename(temporary.c_str(), name.c_str())){
+			_error = errno;
+		}
+	}
+
+} // namespace ostream_color_log
+
+///////////////////////////////////////////////////////////////////////////////
@@ -63,25 +63,53 @@ namespace stl_extensions {
 			THROW_MMF_ERROR() << "Cannot open file!" << endl;
 		}
 
+		// Mapping holds file, so descriptor is not needed after it.
+		try{
+			open(fd, file_name);
+		}catch(...){
+			close(fd);
+			throw;
+		}
+		close(fd);
+	}
+
+	void mmapped_file::open(int fd, const char* file_name) {
+		using namespace std;
+
+		_state = std::make_shared<State>();
+		_state->file_name = file_name;
+
 		// Get file size.
 		struct stat sb;
 		if(fstat(fd, &sb) == -1){
 			THROW_MMF_ERROR() << "Cannot get file size!" << endl;
 		}
-		_state->file_size = sb.st_size;
+		// Empty file cannot be mapped, but it is not an error.
+		if(sb.st_size == 0){
+			return;
+		}
 
 		// mmap file.
-		_state->mapped_memory = reinterpret_cast<uint8_t*>(mmap(
+		void* mapped_memory = mmap(
 				NULL,
-				_state->file_size,
+				sb.st_size,
 				PROT_READ,
 				MAP_PRIVATE,
 				fd,
-				0));
-		if(_state->mapped_memory == MAP_FAILED){
+				0);
+		if(mapped_memory == MAP_FAILED){
 			THROW_MMF_ERROR() << "Failed to map file to memory! errno = "
 					<< errno << endl;
 		}
+		_state->mapped_memory = reinterpret_cast<uint8_t*>(mapped_memory);
+		_state->file_size = sb.st_size;
+	}
+
+	void mmapped_file::advise_sequential() const noexcept {
+		if(_state->mapped_memory){
+			madvise(_state->mapped_memory, _state->file_size,
+					MADV_SEQUENTIAL);
+		}
 	}
 
 	mmapped_file::State::State() {
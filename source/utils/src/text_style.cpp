@@ -0,0 +1,271 @@
+/**
+ * @file text_style.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Colors and attributes of text, and registry of used styles.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ostream_color_log/text_style.h"
+
+#include <cstdlib>
+#include <sstream>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ostream_color_log {
+
+	static const char* basic_names[] = {
+		"black", "red", "green", "yellow", "blue", "magenta", "cyan", "white"
+	};
+
+	static const char* basic_css[] = {
+		"#000", "#f00", "#0f0", "#ff0", "#00f", "#f0f", "#0ff", "#fff"
+	};
+
+	/// First 16 colors of xterm palette.
+	static const uint32_t palette16[] = {
+		0x000000, 0x800000, 0x008000, 0x808000,
+		0x000080, 0x800080, 0x008080, 0xc0c0c0,
+		0x808080, 0xff0000, 0x00ff00, 0xffff00,
+		0x0000ff, 0xff00ff, 0x00ffff, 0xffffff
+	};
+
+	/**
+	 * @return RGB of xterm palette color.
+	 */
+	static uint32_t palette_rgb(uint8_t index) {
+		if(index < 16){
+			return palette16[index];
+		}else if(index < 232){
+			// 6x6x6 cube.
+			index -= 16;
+			uint8_t level[3] = { uint8_t(index / 36), uint8_t(index / 6 % 6),
+					uint8_t(index % 6) };
+			uint32_t rgb = 0;
+			for(int i = 0; i < 3; i++){
+				rgb = rgb << 8 | (level[i] ? 55 + 40 * level[i] : 0);
+			}
+			return rgb;
+		}else{
+			// Gray ramp.
+			uint32_t gray = 8 + 10 * (index - 232);
+			return gray << 16 | gray << 8 | gray;
+		}
+	}
+
+	static std::string hex(uint32_t value, int digits) {
+		static const char* digit = "0123456789abcdef";
+		std::string s(digits, '0');
+		for(int i = digits - 1; i >= 0; i--, value >>= 4){
+			s[i] = digit[value & 0xf];
+		}
+		return s;
+	}
+
+	bool text_color::parse(const std::string& text, text_color& color) {
+		for(int i = 0; i < 8; i++){
+			if(text == basic_names[i]){
+				color = text_color(ostream_colors(black + i));
+				return true;
+			}
+		}
+		if(text.size() == 7 && text[0] == '#'
+				&& text.find_first_not_of("0123456789abcdefABCDEF", 1)
+						== std::string::npos){
+			uint32_t value = strtoul(text.c_str() + 1, 0, 16);
+			color = rgb(value >> 16, value >> 8, value);
+			return true;
+		}
+		if(!text.empty() && text.size() <= 3
+				&& text.find_first_not_of("0123456789") == std::string::npos){
+			unsigned index = strtoul(text.c_str(), 0, 10);
+			if(index < 256){
+				color = indexed(index);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::string text_color::code() const {
+		switch(kind()){
+		case BASIC:
+			return std::string(1, '0' + (value & 0xff));
+		case INDEXED:
+			return "p" + hex(value & 0xff, 2);
+		case RGB:
+			return "r" + hex(value & 0xffffff, 6);
+		case NONE:
+		default:
+			return "x";
+		}
+	}
+
+	std::string text_color::css() const {
+		switch(kind()){
+		case BASIC:
+			return basic_css[value & 7];
+		case INDEXED:
+			return "#" + hex(palette_rgb(value & 0xff), 6);
+		case RGB:
+			return "#" + hex(value & 0xffffff, 6);
+		case NONE:
+		default:
+			return "inherit";
+		}
+	}
+
+	std::string text_color::ansi(bool background) const {
+		std::ostringstream oss;
+		switch(kind()){
+		case BASIC:
+			oss << (background ? '4' : '3') << (value & 7);
+			break;
+		case INDEXED:
+			oss << (background ? "48;5;" : "38;5;") << (value & 0xff);
+			break;
+		case RGB:
+			oss << (background ? "48;2;" : "38;2;") << (value >> 16 & 0xff)
+					<< ';' << (value >> 8 & 0xff) << ';' << (value & 0xff);
+			break;
+		case NONE:
+			break;
+		}
+		return oss.str();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+
+	void text_style::add(ostream_attributes attribute) {
+		switch(attribute){
+		case reset:
+			foreground = text_color();
+			background = text_color();
+			attributes = 0;
+			break;
+		case bold:
+			attributes |= BOLD;
+			break;
+		case underline_v2:
+		case underline:
+			attributes |= UNDERLINE;
+			break;
+		case blink:
+			attributes |= BLINK;
+			break;
+		case hidden:
+			attributes |= HIDDEN;
+			break;
+		case dim:
+		case nothing:
+		case reverse:
+			break;
+		}
+	}
+
+	std::string text_style::css_class() const {
+		static const char* digit = "0123456789abcdef";
+		return "s" + foreground.code() + background.code()
+				+ digit[attributes];
+	}
+
+	std::string text_style::css() const {
+		std::string css;
+		if(foreground.kind() != text_color::NONE){
+			css += "color: " + foreground.css() + "; ";
+		}
+		if(background.kind() != text_color::NONE){
+			css += "background-color: " + background.css() + "; ";
+		}
+		if(attributes & BOLD){
+			css += "font-weight: bold; ";
+		}
+		if(attributes & (UNDERLINE | BLINK)){
+			css += "text-decoration:";
+			if(attributes & UNDERLINE){
+				css += " underline";
+			}
+			if(attributes & BLINK){
+				css += " blink";
+			}
+			css += "; ";
+		}
+		if(attributes & HIDDEN){
+			css += "visibility: hidden; ";
+		}
+		return css;
+	}
+
+	std::string text_style::ansi() const {
+		std::string parameters;
+		if(attributes & BOLD){
+			parameters += ";1";
+		}
+		if(attributes & UNDERLINE){
+			parameters += ";4";
+		}
+		if(attributes & BLINK){
+			parameters += ";5";
+		}
+		if(attributes & HIDDEN){
+			parameters += ";8";
+		}
+		if(foreground.kind() != text_color::NONE){
+			parameters += ";" + foreground.ansi(false);
+		}
+		if(background.kind() != text_color::NONE){
+			parameters += ";" + background.ansi(true);
+		}
+		if(parameters.empty()){
+			return parameters;
+		}
+		// Skip first separator.
+		return "\033[" + parameters.substr(1) + "m";
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+
+	style_registry& style_registry::instance() {
+		static style_registry registry;
+		return registry;
+	}
+
+	size_t style_registry::intern(const text_style& style) {
+		unique_lock<mutex> lock(_mutex);
+		std::map<text_style, size_t>::iterator iter = _ids.find(style);
+		if(iter != _ids.end()){
+			return iter->second;
+		}
+		size_t id = _entries.size();
+		entry e;
+		e.style = style;
+		e.ansi = style.ansi();
+		_entries.push_back(e);
+		_ids[style] = id;
+		_size.store(_entries.size(), std::memory_order_release);
+		return id;
+	}
+
+	text_style style_registry::at(size_t id) {
+		unique_lock<mutex> lock(_mutex);
+		return _entries[id].style;
+	}
+
+	std::string style_registry::ansi(size_t id) {
+		unique_lock<mutex> lock(_mutex);
+		return _entries[id].ansi;
+	}
+
+} // namespace ostream_color_log
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,235 @@
+/**
+ * @file thread_pool.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Pool of threads running small tasks, with work stealing.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "thread_pool.h"
+
+#include <unistd.h>
+#include <sched.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Pool and index of worker running on this thread.
+static thread_local const thread_pool* current_pool = 0;
+static thread_local size_t current_index = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+
+thread_pool::thread_pool(size_t threads, bool pin_threads)
+		: _pin_threads(pin_threads), _next(0), _pending(0), _sleeping(0),
+		_stop(false) {
+	if(threads == 0){
+		threads = cpu_count();
+	}
+	// All deques exist before any worker could steal from them.
+	for(size_t i = 0; i < threads; i++){
+		_workers.push_back(new worker());
+	}
+	for(size_t i = 0; i < threads; i++){
+		worker_call call(this, i);
+		_workers[i]->t = new thread(call);
+	}
+}
+
+thread_pool::~thread_pool() {
+	{
+		unique_lock<mutex> lock(_sleep_mutex);
+		_stop = true;
+		_wake.notify_all();
+	}
+	for(worker* w: _workers){
+		w->t->join();
+		delete w->t;
+	}
+	for(worker* w: _workers){
+		delete w;
+	}
+}
+
+size_t thread_pool::cpu_count() {
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? n : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void thread_pool::submit(const task& t) {
+	size_t index = current();
+	if(index == _workers.size()){
+		index = _next++ % _workers.size();
+	}
+	worker& w = *_workers[index];
+	{
+		unique_lock<mutex> lock(w.lock);
+		w.tasks.push_back(t);
+	}
+	_pending++;
+	// Worker going to sleep counts itself before it checks
+	// for tasks, so one of two sides always sees the other.
+	if(_sleeping){
+		unique_lock<mutex> lock(_sleep_mutex);
+		_wake.notify_one();
+	}
+}
+
+bool thread_pool::run_pending() {
+	size_t index = current();
+	task t;
+	if((index < _workers.size() && pop(index, t)) || steal(index, t)){
+		t();
+		return true;
+	}
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void thread_pool::work(size_t index) {
+	current_pool = this;
+	current_index = index;
+
+	if(_pin_threads){
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(index % cpu_count(), &set);
+		sched_setaffinity(0, sizeof(set), &set);
+	}
+
+	task t;
+	while(true){
+		if(pop(index, t) || steal(index, t)){
+			t();
+			// Do not keep captured data alive until next task.
+			t = task();
+			continue;
+		}
+
+		unique_lock<mutex> lock(_sleep_mutex);
+		_sleeping++;
+		while(!_pending && !_stop){
+			_wake.wait(lock);
+		}
+		_sleeping--;
+		if(!_pending && _stop){
+			break;
+		}
+	}
+}
+
+bool thread_pool::pop(size_t index, task& t) {
+	worker& w = *_workers[index];
+	unique_lock<mutex> lock(w.lock);
+	if(w.tasks.empty()){
+		return false;
+	}
+	t.swap(w.tasks.back());
+	w.tasks.pop_back();
+	_pending--;
+	return true;
+}
+
+bool thread_pool::steal(size_t thief, task& t) {
+	if(!_pending){
+		return false;
+	}
+	// Start from neighbour, so thieves do not all go to same victim.
+	size_t n = _workers.size();
+	for(size_t i = 1; i <= n; i++){
+		size_t victim = (thief + i) % n;
+		if(victim == thief){
+			continue;
+		}
+		worker& w = *_workers[victim];
+		unique_lock<mutex> lock(w.lock);
+		if(!w.tasks.empty()){
+			t.swap(w.tasks.front());
+			w.tasks.pop_front();
+			_pending--;
+			return true;
+		}
+	}
+	return false;
+}
+
+size_t thread_pool::current() const noexcept {
+	return current_pool == this ? current_index : _workers.size();
+}
+
+void thread_pool::block(const std::atomic<size_t>& running) {
+	// Blocked thread is woken by submit() as sleeping worker is,
+	// so task put to deque of blocked worker is not left there.
+	unique_lock<mutex> lock(_sleep_mutex);
+	_sleeping++;
+	while(running && !_pending){
+		_wake.wait(lock);
+	}
+	_sleeping--;
+}
+
+void thread_pool::wake_blocked() {
+	// Same ordering as in submit(), blocked thread counts itself
+	// before it checks group.
+	if(_sleeping){
+		unique_lock<mutex> lock(_sleep_mutex);
+		_wake.notify_all();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+task_group::~task_group() {
+	try{
+		wait();
+	}catch(...){
+		// Destructor must not throw, call wait() to get exception.
+	}
+}
+
+void task_group::run(const thread_pool::task& t) {
+	_running++;
+	_pool.submit([this, t]() {
+		try{
+			t();
+		}catch(...){
+			unique_lock<mutex> lock(_error_mutex);
+			if(!_error){
+				_error = std::current_exception();
+			}
+		}
+		// Group could be destroyed as soon as counter gets to 0.
+		thread_pool& pool = _pool;
+		if(--_running == 0){
+			pool.wake_blocked();
+		}
+	});
+}
+
+void task_group::wait() {
+	while(_running){
+		// Help with tasks, and sleep only when there is none.
+		if(!_pool.run_pending()){
+			_pool.block(_running);
+		}
+	}
+	unique_lock<mutex> lock(_error_mutex);
+	if(_error){
+		std::exception_ptr error = _error;
+		_error = std::exception_ptr();
+		std::rethrow_exception(error);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
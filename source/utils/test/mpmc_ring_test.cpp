@@ -0,0 +1,118 @@
+/**
+ * @file mpmc_ring_test.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Test of mpmc_ring.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "stl_extensions/mpmc_ring.h"
+#include "thread.h"
+
+#include <iostream>
+#include <vector>
+#include <functional>
+
+using namespace std;
+using namespace stl_extensions;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures = 0;
+
+static void check(bool ok, const char* what){
+	if(!ok){
+		cerr << "mpmc_ring_test: " << what << " failed!" << endl;
+		failures++;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Smallest rings do not take more than they could hold.
+ */
+static void testMinimumCapacity(){
+	for(size_t capacity = 0; capacity <= 2; capacity++){
+		mpmc_ring<int> ring(capacity);
+		check(ring.capacity() == 2, "minimum capacity");
+		check(ring.try_push(1) && ring.try_push(2), "pushing to free ring");
+		check(!ring.try_push(3), "pushing to full ring");
+		int values[3];
+		check(ring.try_pop_n(values, 3) == 2 && values[0] == 1
+				&& values[1] == 2, "popping from full ring");
+		check(!ring.try_pop(values[0]), "popping from empty ring");
+	}
+}
+
+/**
+ * Elements go through smallest ring between threads,
+ * none is lost or doubled.
+ */
+static void testSmallRingThreads(){
+	mpmc_ring<int> ring(1);
+	const int count = 100000;
+	vector<function<void()>> calls;
+	vector<long> sums(2, 0);
+	for(int c = 0; c < 2; c++){
+		calls.push_back([&ring, &sums, c]() {
+			while(true){
+				int value;
+				ring.pop(value);
+				if(value < 0){
+					return;
+				}
+				sums[c] += value;
+			}
+		});
+	}
+	for(int p = 0; p < 2; p++){
+		calls.push_back([&ring, count]() {
+			for(int i = 1; i <= count; i++){
+				ring.push(i);
+			}
+		});
+	}
+	vector<thread*> threads;
+	for(function<void()>& call: calls){
+		threads.push_back(new thread(call));
+	}
+	// Producers first, then stop consumers.
+	for(int i = 2; i < 4; i++){
+		threads[i]->join();
+	}
+	ring.push(-1);
+	ring.push(-1);
+	for(int i = 0; i < 2; i++){
+		threads[i]->join();
+	}
+	for(thread* t: threads){
+		delete t;
+	}
+	check(sums[0] + sums[1] == 2L * count * (count + 1) / 2,
+			"passing elements through small ring");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(){
+	testMinimumCapacity();
+	testSmallRingThreads();
+
+	if(failures){
+		return 1;
+	}
+	cout << "mpmc_ring_test: all passed" << endl;
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
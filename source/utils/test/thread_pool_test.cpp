@@ -0,0 +1,206 @@
+/**
+ * @file thread_pool_test.cpp
+ * @date Oct 17, 2026
+ *
+ * @author Milos Subotic <milos.subotic.sm@gmail.com>
+ * @license LGPLv3
+ *
+ * @brief Test of thread_pool and task_group.
+ *
+ * @version 1.0
+ * Changelog:
+ * 1.0 - Initial version.
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "thread_pool.h"
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <sched.h>
+#include <time.h>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures = 0;
+
+static void check(bool ok, const char* what){
+	if(!ok){
+		cerr << "thread_pool_test: " << what << " failed!" << endl;
+		failures++;
+	}
+}
+
+/**
+ * Sum of numbers from first to last, split in halves down to small
+ * ranges. Each half is task of its own group, so groups are waited
+ * for inside of tasks.
+ */
+static long sum(thread_pool& pool, long first, long last){
+	if(last - first < 1000){
+		long s = 0;
+		for(long i = first; i <= last; i++){
+			s += i;
+		}
+		return s;
+	}
+	long middle = first + (last - first) / 2;
+	long left = 0;
+	task_group group(pool);
+	group.run([&]() { left = sum(pool, first, middle); });
+	long right = sum(pool, middle + 1, last);
+	group.wait();
+	return left + right;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Fork and join from outside of pool and from tasks.
+ */
+static void testForkJoin(size_t threads){
+	thread_pool pool(threads);
+	long n = 1000000;
+	check(sum(pool, 1, n) == n * (n + 1) / 2, "fork/join sum");
+
+	// Group could be used again after wait().
+	atomic<long> count(0);
+	task_group group(pool);
+	for(int round = 0; round < 3; round++){
+		for(int i = 0; i < 10000; i++){
+			group.run([&count]() { count++; });
+		}
+		group.wait();
+		check(count == (round + 1) * 10000, "waiting for all tasks");
+	}
+}
+
+/**
+ * Tasks of worker which is busy are run by other workers.
+ */
+static void testStealing(){
+	thread_pool pool(2);
+	atomic<int> done(0);
+	atomic<bool> finished(false);
+	pool.submit([&]() {
+		// Both go to deque of this worker, and it does not take
+		// them while it spins, so they could only be stolen.
+		pool.submit([&done]() { done++; });
+		pool.submit([&done]() { done++; });
+		while(done != 2){
+			sched_yield();
+		}
+		finished = true;
+	});
+	while(!finished){
+		sched_yield();
+	}
+	check(done == 2, "stealing");
+}
+
+/**
+ * Thread waiting for long task sleeps instead of spinning.
+ */
+static void testBlockingWait(){
+	thread_pool pool(1);
+	task_group group(pool);
+	atomic<bool> started(false);
+	group.run([&started]() {
+		started = true;
+		sleepMs(300);
+	});
+	// Otherwise waiting thread could take task and run it itself.
+	while(!started){
+		sched_yield();
+	}
+	struct timespec start, end;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	group.wait();
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	double cpu = (end.tv_sec - start.tv_sec)
+			+ (end.tv_nsec - start.tv_nsec) / 1e9;
+	check(cpu < 0.1, "sleeping while waiting");
+}
+
+/**
+ * First exception of group is thrown from wait().
+ */
+static void testException(){
+	thread_pool pool(2);
+	task_group group(pool);
+	atomic<int> count(0);
+	for(int i = 0; i < 100; i++){
+		group.run([&count, i]() {
+			count++;
+			if(i == 50){
+				throw runtime_error("task failed");
+			}
+		});
+	}
+	bool thrown = false;
+	try{
+		group.wait();
+	}catch(const runtime_error&){
+		thrown = true;
+	}
+	check(thrown, "exception from task");
+	check(count == 100, "running tasks after exception");
+	// Exception is thrown only once.
+	thrown = false;
+	try{
+		group.wait();
+	}catch(...){
+		thrown = true;
+	}
+	check(!thrown, "clearing exception");
+}
+
+/**
+ * Pool with pinned workers runs tasks as any other.
+ */
+static void testPinned(){
+	thread_pool pool(2, true);
+	long n = 100000;
+	check(sum(pool, 1, n) == n * (n + 1) / 2, "pinned fork/join sum");
+}
+
+/**
+ * Tasks submitted before destruction are all run.
+ */
+static void testDestruction(){
+	atomic<int> count(0);
+	{
+		thread_pool pool(3);
+		for(int i = 0; i < 1000; i++){
+			pool.submit([&count]() { count++; });
+		}
+	}
+	check(count == 1000, "running tasks in destructor");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(){
+	for(size_t threads = 1; threads <= 4; threads++){
+		testForkJoin(threads);
+	}
+	testStealing();
+	testBlockingWait();
+	testException();
+	testPinned();
+	testDestruction();
+
+	if(failures){
+		return 1;
+	}
+	cout << "thread_pool_test: all passed" << endl;
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
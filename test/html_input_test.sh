@@ -0,0 +1,61 @@
+#!/bin/bash
+#
+# @file: html_input_test.sh
+# @date: Oct 17, 2026
+#
+# @author: Milos Subotic <milos.subotic.sm@gmail.com>
+# @license: LGPLv3
+#
+# @brief: Test that HTML output does not depend on how input is read.
+# Mapped file, piped input and mapped file colored on many workers
+# are split to batches differently, but must give same HTML.
+# Run with many more workers than CPUs checks that pipeline does not hang.
+#
+# Usage: html_input_test.sh [coloring_tee]
+#
+# @version: 1.0
+# Changelog:
+# 1.0 - Initial version.
+#
+
+###############################################################################
+
+TEST_DIR=$(cd $(dirname $0) && pwd)
+PROGRAM=$(readlink -f ${1:-$TEST_DIR/../build/source/coloring_tee/coloring_tee})
+CONFIG=--config=$TEST_DIR/../share/coloring_tee/config.lua
+
+WORK_DIR=$(mktemp -d)
+trap "rm -rf $WORK_DIR" EXIT
+cd $WORK_DIR
+# User configuration is not touched.
+export HOME=$WORK_DIR
+
+# Many batches of lines with changing and repeating styles.
+for i in $(seq 3000); do
+	cat $TEST_DIR/log.logcat
+done > input.log
+
+mkdir mapped piped workers many_workers
+(cd mapped && $PROGRAM $CONFIG -c=logcat --html=out.html \
+	--input=../input.log > /dev/null)
+(cd piped && cat ../input.log | $PROGRAM $CONFIG -c=logcat --html=out.html \
+	> /dev/null)
+(cd workers && $PROGRAM $CONFIG -c=logcat -j=4 --html=out.html \
+	--input=../input.log > /dev/null)
+# More workers than batches fit in queues used to hang.
+(cd many_workers && timeout 60 $PROGRAM $CONFIG -c=logcat -j=64 \
+	--html=out.html --input=../input.log > /dev/null)
+
+FAILED=0
+for d in piped workers many_workers; do
+	if ! cmp -s mapped/out.html $d/out.html; then
+		echo "html_input_test: HTML of $d input differs from mapped one!"
+		FAILED=1
+	fi
+done
+if [ $FAILED -eq 0 ]; then
+	echo "html_input_test: all passed"
+fi
+exit $FAILED
+
+###############################################################################